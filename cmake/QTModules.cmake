@@ -3,7 +3,7 @@ set(MODULES)
 
 set(QT_DEFAULT_MAJOR_VERSION 6)
 
-set(QT_COMPONENTS Core Gui Widgets Network Sql StateMachine)
+set(QT_COMPONENTS Core Gui Widgets Network Sql StateMachine Concurrent)
 
 if (ENABLE_TESTS)
 	list(APPEND QT_COMPONENTS Test)
@@ -2,15 +2,20 @@
 
 AppManager::AppManager(QObject* parent) :
 	QObject(parent), uiManager(UIManager::getInstance(this)), clientHandler(new ClientHandler()),
-	AppManagerThread(new QThread())
+	AppManagerThread(new QThread()), decoder(new ResponseDecoderWorker()), DecoderThread(new QThread())
 {
 	clientHandler->moveToThread(AppManagerThread);
+	decoder->moveToThread(DecoderThread);
 
 	connect(uiManager, &UIManager::makeRequest, clientHandler, &ClientHandler::sendRequest);
 	connect(uiManager, &UIManager::requestConnection, clientHandler, &ClientHandler::requestClientConnection);
 	connect(uiManager, &UIManager::requestDisconnection, clientHandler, &ClientHandler::requestClientDisconnection);
 
-	connect(clientHandler, &ClientHandler::sendResponseBack, uiManager, &UIManager::responseReady);
+	// Messages cross these queued connections as shared pointers, their payloads are never copied
+	connect(clientHandler, &ClientHandler::sendResponseBack, decoder, &ResponseDecoderWorker::decode);
+	connect(decoder, &ResponseDecoderWorker::responseDecoded, uiManager, &UIManager::responseDecoded);
+	connect(clientHandler, &ClientHandler::backpressureChanged, RequestManager::getInstance(),
+			&RequestManager::onBackpressureChanged);
 
 	connect(AppManagerThread, &QThread::started, clientHandler, &ClientHandler::run);
 	connect(AppManagerThread, &QThread::finished, AppManagerThread, &QThread::deleteLater);
@@ -18,6 +23,7 @@ AppManager::AppManager(QObject* parent) :
 
 void AppManager::start()
 {
+	DecoderThread->start();
 	AppManagerThread->start();
 }
 
@@ -29,6 +35,11 @@ AppManager& AppManager::getInstance(QObject* parent)
 
 AppManager::~AppManager()
 {
+	DecoderThread->quit();
+	DecoderThread->wait();
+
 	delete uiManager;
 	delete clientHandler;
+	delete decoder;
+	delete DecoderThread;
 }
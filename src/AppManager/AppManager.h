@@ -6,12 +6,15 @@
 #include <QThread>
 #include "UIManager.h"
 #include "ClientHandler.h"
+#include "ResponseDecoderWorker.h"
 
 /**
  * @file AppManager.h
  * @brief Manages the application's UI and client handling in separate threads.
  * @details This class is responsible for coordinating between the UI and the client handler,
  * ensuring that the application remains responsive by running the client handling logic in a separate thread.
+ * Replies flow through three stages: socket I/O on AppManagerThread, decoding on DecoderThread, and
+ * applying the decoded results on the GUI thread.
  */
 class AppManager : public QObject
 {
@@ -22,6 +25,8 @@ private:
 	ClientHandler*
 			 clientHandler; /**< Pointer to the ClientHandler instance, which handles communication with the server. */
 	QThread* AppManagerThread; /**< Thread to run the ClientHandler, keeping the main GUI responsive. */
+	ResponseDecoderWorker* decoder; /**< Decodes replies between the ClientHandler and the UIManager. */
+	QThread*			   DecoderThread; /**< Thread to run the ResponseDecoderWorker. */
 
 	/**
      * @brief Private constructor for the AppManager class.
@@ -32,8 +37,8 @@ private:
 
 public:
 	/**
-     * @brief Starts the AppManager thread.
-     * @details This function starts the QThread which runs the ClientHandler.
+     * @brief Starts the AppManager and decoder threads.
+     * @details This function starts the QThreads which run the ClientHandler and the ResponseDecoderWorker.
      */
 	void start();
 
@@ -56,7 +61,7 @@ public:
 
 	/**
      * @brief Destructor for the AppManager class.
-     * @details Cleans up the UIManager and ClientHandler instances.
+     * @details Stops the decoder thread and cleans up the UIManager, ClientHandler and ResponseDecoderWorker instances.
      */
 	~AppManager();
 };
@@ -9,6 +9,9 @@ UIManager::UIManager(QObject* parent) :
 	requestManager = RequestManager::getInstance(this);
 
 	connect(requestManager, &RequestManager::makeRequest, this, &UIManager::requestReady);
+	connect(requestManager, &RequestManager::requestDropped, this, &UIManager::onRequestDropped);
+	connect(responseManager, &ResponseManager::SessionOpened, requestManager, &RequestManager::setSessionToken);
+	connect(responseManager, &ResponseManager::SessionExpired, requestManager, &RequestManager::onSessionExpired);
 
 	connect(responseManager, &ResponseManager::userloginSuccess, this, &UIManager::createUserWidget);
 	connect(responseManager, &ResponseManager::adminLoginSuccess, this, &UIManager::createAdminWidget);
@@ -37,14 +40,14 @@ UIManager* UIManager::getInstance(QObject* parent)
 	return instance;
 }
 
-void UIManager::responseReady(QJsonObject Data)
+void UIManager::responseDecoded(ResponsePtr response)
 {
-	responseManager->handleResponse(Data);
+	responseManager->handleDecodedResponse(*response);
 }
 
-void UIManager::requestReady(QJsonObject Data)
+void UIManager::requestReady(MessagePtr request)
 {
-	emit makeRequest(Data);
+	emit makeRequest(request);
 }
 
 void UIManager::logout()
@@ -60,6 +63,8 @@ void UIManager::logout()
 		closeAdminWidget();
 	}
 
+	requestManager->closeSession();
+
 	loginWidget->clearFields();
 
 	stackedWidget->setCurrentWidget(loginWidget);
@@ -71,7 +76,7 @@ void UIManager::createLoginWidget()
 		loginWidget = new LoginWidget(mainWindow);
 		connect(loginWidget, &LoginWidget::connectToServer, this, &UIManager::connectToTheServer);
 		connect(loginWidget, &LoginWidget::disconnectFromServer, this, &UIManager::disconnectFromTheServer);
-		connect(loginWidget, &LoginWidget::sendLoginRequest, this, &UIManager::requestReady);
+		connect(responseManager, &ResponseManager::LoginAccepted, loginWidget, &LoginWidget::onLoginAccepted);
 	}
 
 	mainWindow->setWindowTitle("Login Page");
@@ -81,6 +86,9 @@ void UIManager::createLoginWidget()
 
 void UIManager::createAdminWidget(QString email, QString first_name)
 {
+	// The widget's requests are made on behalf of the admin from now on
+	requestManager->openSession(email);
+
 	if (adminWidget == nullptr)
 	{
 		adminWidget = new AdminWidget(email, first_name, mainWindow);
@@ -90,6 +98,12 @@ void UIManager::createAdminWidget(QString email, QString first_name)
 
 		connect(responseManager, &ResponseManager::DatabaseFetched, adminWidget,
 				&AdminWidget::onDatabaseContentUpdated);
+		connect(responseManager, &ResponseManager::ResultUnchanged, adminWidget, &AdminWidget::onResultUnchanged);
+		connect(responseManager, &ResponseManager::UsersFound, adminWidget, &AdminWidget::onUsersFound);
+		connect(responseManager, &ResponseManager::UsersChanged, adminWidget, &AdminWidget::onUsersChanged);
+		connect(responseManager, &ResponseManager::SubscriptionChanged, adminWidget,
+				&AdminWidget::onSubscriptionChanged);
+		connect(responseManager, &ResponseManager::ConnectionResponse, adminWidget, &AdminWidget::onConnectionChanged);
 	}
 
 	mainWindow->setWindowTitle("Admin Page");
@@ -99,12 +113,22 @@ void UIManager::createAdminWidget(QString email, QString first_name)
 
 void UIManager::createUserWidget(QString email, QString first_name, QString account_number, QString balance)
 {
+	// The widget's requests are made on behalf of the user from now on
+	requestManager->openSession(email);
+
 	if (userWidget == nullptr)
 	{
 		userWidget = new UserWidget(email, first_name, account_number, balance, mainWindow);
 		connect(userWidget, &UserWidget::logout, this, &UIManager::logout);
 		connect(responseManager, &ResponseManager::TransactionsFetched, userWidget, &UserWidget::onTransactionsFetched);
 		connect(responseManager, &ResponseManager::BalanceFetched, userWidget, &UserWidget::onBalanceFetched);
+		connect(responseManager, &ResponseManager::ResultUnchanged, userWidget, &UserWidget::onResultUnchanged);
+		connect(responseManager, &ResponseManager::SubscriptionChanged, userWidget,
+				&UserWidget::onSubscriptionChanged);
+		connect(responseManager, &ResponseManager::BalanceChanged, userWidget, &UserWidget::onBalanceChanged);
+		connect(responseManager, &ResponseManager::TransactionsPushed, userWidget, &UserWidget::onTransactionsPushed);
+		connect(responseManager, &ResponseManager::UsersFound, userWidget, &UserWidget::onUsersFound);
+		connect(responseManager, &ResponseManager::ConnectionResponse, userWidget, &UserWidget::onConnectionChanged);
 	}
 
 	mainWindow->setWindowTitle("User Page");
@@ -128,6 +152,12 @@ void UIManager::onSuccessfullNotification(QString message)
 	}
 }
 
+void UIManager::onRequestDropped(qint64 requestId)
+{
+	Q_UNUSED(requestId);
+	onFailedNotification("Too many requests are waiting for the server, please try again");
+}
+
 void UIManager::onFailedNotification(QString message)
 {
 	if (userWidget != nullptr)
@@ -150,6 +180,11 @@ void UIManager::closeAdminWidget()
 	disconnect(responseManager, &ResponseManager::TransactionsFetched, adminWidget,
 			   &AdminWidget::onTransactionsFetched);
 	disconnect(responseManager, &ResponseManager::DatabaseFetched, adminWidget, &AdminWidget::onDatabaseContentUpdated);
+	disconnect(responseManager, &ResponseManager::ResultUnchanged, adminWidget, &AdminWidget::onResultUnchanged);
+	disconnect(responseManager, &ResponseManager::UsersFound, adminWidget, &AdminWidget::onUsersFound);
+	disconnect(responseManager, &ResponseManager::UsersChanged, adminWidget, &AdminWidget::onUsersChanged);
+	disconnect(responseManager, &ResponseManager::SubscriptionChanged, adminWidget, &AdminWidget::onSubscriptionChanged);
+	disconnect(responseManager, &ResponseManager::ConnectionResponse, adminWidget, &AdminWidget::onConnectionChanged);
 
 	stackedWidget->removeWidget(adminWidget);
 	adminWidget->deleteLater();
@@ -161,6 +196,12 @@ void UIManager::closeUserWidget()
 	disconnect(adminWidget, &AdminWidget::logout, this, &UIManager::logout);
 	disconnect(responseManager, &ResponseManager::TransactionsFetched, userWidget, &UserWidget::onTransactionsFetched);
 	disconnect(responseManager, &ResponseManager::BalanceFetched, userWidget, &UserWidget::onBalanceFetched);
+	disconnect(responseManager, &ResponseManager::ResultUnchanged, userWidget, &UserWidget::onResultUnchanged);
+	disconnect(responseManager, &ResponseManager::SubscriptionChanged, userWidget, &UserWidget::onSubscriptionChanged);
+	disconnect(responseManager, &ResponseManager::BalanceChanged, userWidget, &UserWidget::onBalanceChanged);
+	disconnect(responseManager, &ResponseManager::TransactionsPushed, userWidget, &UserWidget::onTransactionsPushed);
+	disconnect(responseManager, &ResponseManager::UsersFound, userWidget, &UserWidget::onUsersFound);
+	disconnect(responseManager, &ResponseManager::ConnectionResponse, userWidget, &UserWidget::onConnectionChanged);
 
 	stackedWidget->removeWidget(userWidget);
 	userWidget->deleteLater();
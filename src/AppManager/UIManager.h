@@ -72,9 +72,9 @@ public:
 signals:
 	/**
      * @brief Signal emitted when a request is ready to be sent to the server.
-     * @param Data JSON object containing the request data.
+     * @param request The request to send.
      */
-	void makeRequest(QJsonObject Data);
+	void makeRequest(MessagePtr request);
 
 	/**
      * @brief Signal emitted to request a connection to the server.
@@ -90,16 +90,16 @@ signals:
 
 public slots:
 	/**
-     * @brief Slot to handle responses from the server.
-     * @param Data JSON object containing the response data.
+     * @brief Slot to apply a response decoded by the decode thread.
+     * @param response The decoded response.
      */
-	void responseReady(QJsonObject Data);
+	void responseDecoded(ResponsePtr response);
 
 	/**
      * @brief Slot to handle requests that are ready to be sent.
-     * @param Data JSON object containing the request data.
+     * @param request The request to forward to the ClientHandler.
      */
-	void requestReady(QJsonObject Data);
+	void requestReady(MessagePtr request);
 
 	/**
      * @brief Logs out the current user.
@@ -141,6 +141,12 @@ public slots:
      */
 	void onFailedNotification(QString message);
 
+	/**
+     * @brief Tells the user that a request was dropped because too many are waiting for the server.
+     * @param requestId The RequestId of the dropped request.
+     */
+	void onRequestDropped(qint64 requestId);
+
 	/**
      * @brief Closes the admin widget.
      */
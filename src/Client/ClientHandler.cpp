@@ -8,8 +8,16 @@
 
 #include "ClientHandler.h"
 #include <QDebug>
+#include <QJsonArray>
+#include <QLoggingCategory>
 
-ClientHandler::ClientHandler(QObject* parent) : QObject(parent), tcpClient(nullptr)
+#include "RequestManager.h"
+
+// Reply timings are only logged when enabled, e.g. with QT_LOGGING_RULES="client.requests.debug=true"
+Q_LOGGING_CATEGORY(lcRequests, "client.requests", QtInfoMsg)
+
+ClientHandler::ClientHandler(QObject* parent) :
+	QObject(parent), tcpClient(nullptr), highWaterMark(1024 * 1024), codec(&MessageCodec::forFormat(MessageCodec::Json))
 {
 }
 
@@ -26,22 +34,63 @@ void ClientHandler::run()
 	connect(tcpClient, &TcpClient::ResponseReadySignal, this, &ClientHandler::onResponseReady);
 	connect(tcpClient, &TcpClient::ConnectedSignal, this, &ClientHandler::onConnectedSignal);
 	connect(tcpClient, &TcpClient::DisconnectedSignal, this, &ClientHandler::onDisconnectedSignal);
+	connect(tcpClient, &TcpClient::BackpressureSignal, this, &ClientHandler::onBackpressureSignal);
+	tcpClient->setHighWaterMark(highWaterMark);
 	loop.exec();
 }
 
-void ClientHandler::sendRequest(QJsonObject request)
+void ClientHandler::sendRequest(MessagePtr message)
 {
-	QJsonDocument jsonDoc(request);
-	QByteArray	  jsonByteArray = jsonDoc.toJson();
-	tcpClient->sendTcpRequest(jsonByteArray);
+	const QJsonObject& request = message->envelope();
+	QByteArray		   payload = codec->encode(request);
+	quint8	   flags = codec->format() == MessageCodec::Cbor ? MessageFrame::CborPayload : 0;
+
+	if (tcpClient->sendTcpRequest(payload, flags) && request.contains("RequestId"))
+	{
+		InFlightRequest entry;
+		entry.type = request.value("Request").toInt();
+		entry.timer.start();
+
+		inFlight.insert(request.value("RequestId").toInteger(), entry);
+	}
 }
 
-void ClientHandler::onResponseReady(QByteArray response)
+void ClientHandler::onResponseReady(MessagePtr message)
 {
-	QJsonDocument jsonResponse = QJsonDocument::fromJson(response);
-	QJsonObject	  jsonObject = jsonResponse.object();
+	const QByteArray&	   response = message->payload();
+	const MessageCodec&	   replyCodec = MessageCodec::forFormat(message->format());
+	MessageCodec::Envelope envelope;
+
+	if (!replyCodec.peek(response, envelope))
+	{
+		qWarning() << "Dropping a malformed" << replyCodec.name() << "reply of" << response.size() << "bytes";
+		return;
+	}
 
-	emit sendResponseBack(jsonObject);
+	if (envelope.code == RequestManager::Handshake)
+	{
+		onHandshakeResponse(replyCodec.decode(response).value("Data").toObject());
+		return;
+	}
+
+	// Replies without an identifier are forwarded as they are (older servers, server initiated messages)
+	if (envelope.hasRequestId)
+	{
+		auto it = inFlight.find(envelope.requestId);
+
+		if (it == inFlight.end())
+		{
+			// Not sent on this connection, or answered already
+			qWarning() << "Dropping reply to unknown request" << envelope.requestId;
+			return;
+		}
+
+		qCDebug(lcRequests) << "Request" << envelope.requestId << "of type" << it->type << "answered in"
+							<< it->timer.elapsed() << "ms," << inFlight.size() - 1 << "still in flight";
+		inFlight.erase(it);
+	}
+
+	emit sendResponseBack(message);
 }
 
 void ClientHandler::requestClientConnection(const QString& host, quint16 port)
@@ -57,22 +106,106 @@ void ClientHandler::requestClientDisconnection()
 
 void ClientHandler::onConnectedSignal()
 {
+	sendHandshake();
+
 	QJsonObject response;
 	response.insert("Response", -2);
 	QJsonObject data;
 	data.insert("status", 1);
 	response.insert("Data", data);
 
-	emit sendResponseBack(response);
+	emit sendResponseBack(NetworkMessage::fromEnvelope(response));
 }
 
 void ClientHandler::onDisconnectedSignal()
 {
+	codec = &MessageCodec::forFormat(MessageCodec::Json);
+	tcpClient->setCompressionThreshold(0);
+	logCompressionStats();
+
+	// Replies to these requests can no longer arrive on this connection
+	if (!inFlight.isEmpty())
+	{
+		qWarning() << "Connection lost with" << inFlight.size() << "requests in flight";
+		inFlight.clear();
+	}
+
 	QJsonObject response;
 	response.insert("Response", -2);
 	QJsonObject data;
 	data.insert("status", 0);
 	response.insert("Data", data);
 
-	emit sendResponseBack(response);
+	emit sendResponseBack(NetworkMessage::fromEnvelope(response));
+}
+
+void ClientHandler::onBackpressureSignal(bool congested)
+{
+	qDebug() << (congested ? "Outbound queue congested," : "Outbound queue drained,") << tcpClient->pendingBytes()
+			 << "bytes pending";
+
+	emit backpressureChanged(congested);
+}
+
+void ClientHandler::setOutboundHighWaterMark(qint64 bytes)
+{
+	highWaterMark = bytes;
+
+	if (tcpClient != nullptr)
+	{
+		tcpClient->setHighWaterMark(bytes);
+	}
+}
+
+void ClientHandler::sendHandshake()
+{
+	codec = &MessageCodec::forFormat(MessageCodec::Json);
+	tcpClient->setCompressionThreshold(0);
+
+	// Without framing there is no way to tell the payload encoding, stay on JSON
+	if (tcpClient->wireMode() != TcpClient::FramedMode)
+	{
+		return;
+	}
+
+	QJsonObject data;
+	data.insert("codecs", QJsonArray::fromStringList(MessageCodec::supportedNames()));
+	data.insert("compression", QJsonArray({"zlib"}));
+	data.insert("compression_threshold", CompressionThreshold);
+
+	QJsonObject request;
+	request.insert("Request", RequestManager::Handshake);
+	request.insert("Data", data);
+
+	tcpClient->sendTcpRequest(codec->encode(request));
+}
+
+void ClientHandler::onHandshakeResponse(const QJsonObject& data)
+{
+	if (data.value("compression").toString() == "zlib")
+	{
+		tcpClient->setCompressionThreshold(CompressionThreshold);
+		qInfo() << "Compressing payloads of" << CompressionThreshold << "bytes and more";
+	}
+
+	const MessageCodec* chosen = MessageCodec::forName(data.value("codec").toString());
+
+	if (data.value("status").toInt() != 1 || chosen == nullptr)
+	{
+		qInfo() << "Codec negotiation declined, staying on" << codec->name();
+		return;
+	}
+
+	codec = chosen;
+	qInfo() << "Using the" << codec->name() << "codec";
+}
+
+void ClientHandler::logCompressionStats() const
+{
+	const TcpClient::CompressionStats& inbound = tcpClient->inboundCompressionStats();
+	const TcpClient::CompressionStats& outbound = tcpClient->outboundCompressionStats();
+
+	qInfo().nospace() << "Compression: received " << inbound.frames << " frames, ratio " << inbound.ratio() << ", "
+					  << inbound.elapsedNs / 1000 << " us inflating; sent " << outbound.frames << " frames, ratio "
+					  << outbound.ratio() << ", " << outbound.elapsedNs / 1000 << " us compressing";
 }
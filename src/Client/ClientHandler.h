@@ -14,7 +14,10 @@
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QThread>
+#include <QHash>
+#include <QElapsedTimer>
 #include "tcpclient.h"
+#include "MessageCodec.h"
 
 /**
  * @class ClientHandler
@@ -23,6 +26,23 @@
  * The ClientHandler class handles the client-side operations such as sending requests,
  * receiving responses, and managing connections. It uses the TcpClient class to handle
  * the actual TCP communication.
+ *
+ * Requests are correlated with their replies through the "RequestId" field of the envelope. The
+ * ClientHandler keeps a table of the requests in flight, so any number of them can be outstanding
+ * at once and their replies may come back in any order.
+ *
+ * Right after connecting, the ClientHandler offers the codecs of @ref MessageCodec to the server.
+ * Envelopes are sent as JSON text until the server picks one, and every received frame is decoded
+ * according to its own @ref MessageFrame::CborPayload flag.
+ *
+ * Replies are not decoded here: only their routing fields are peeked with MessageCodec::peek(), and the
+ * received message is forwarded as it is through sendResponseBack(). Replies whose routing fields cannot
+ * be read are dropped. The time taken by each reply is logged in the "client.requests" category, which
+ * is disabled by default.
+ *
+ * The handshake also offers zlib payload compression. Replies are inflated by the TcpClient whenever they
+ * are flagged as compressed, and requests of at least @ref CompressionThreshold bytes are compressed once
+ * the server has accepted it.
  */
 class ClientHandler : public QObject
 {
@@ -47,15 +67,15 @@ public:
 public slots:
 	/**
      * @brief Sends a request to the server.
-     * @param request The JSON object containing the request data.
+     * @param request The request, whose envelope is encoded here exactly once.
      */
-	void sendRequest(QJsonObject request);
+	void sendRequest(MessagePtr request);
 
 	/**
      * @brief Slot to handle the response received from the server.
-     * @param response The response data in QByteArray format.
+     * @param response The encoded response.
      */
-	void onResponseReady(QByteArray response);
+	void onResponseReady(MessagePtr response);
 
 	/**
      * @brief Requests a connection to the server.
@@ -79,15 +99,64 @@ public slots:
      */
 	void onDisconnectedSignal();
 
+	/**
+     * @brief Slot to handle backpressure changes of the outbound queue.
+     * @param congested true when the outbound backlog is above the high-water mark.
+     */
+	void onBackpressureSignal(bool congested);
+
+	/**
+     * @brief Sets the outbound backlog above which backpressure is signalled.
+     * @param bytes The high-water mark in bytes.
+     */
+	void setOutboundHighWaterMark(qint64 bytes);
+
 signals:
 	/**
      * @brief Signal to send the response back to the window manager.
-     * @param response The JSON object containing the response data.
+     * @param response The server reply as received, or a connection event built by the ClientHandler.
+     */
+	void sendResponseBack(MessagePtr response);
+
+	/**
+     * @brief Signal to tell request producers to hold back or resume.
+     * @param congested true when requests should be held back, false when they may flow again.
      */
-	void sendResponseBack(QJsonObject response);
+	void backpressureChanged(bool congested);
 
 private:
-	TcpClient* tcpClient; ///< Pointer to the TcpClient instance.
+	/**
+     * @brief Offers the supported codecs to the server.
+     */
+	void sendHandshake();
+
+	/**
+     * @brief Switches to the codec chosen by the server.
+     * @param data The "Data" object of the handshake reply.
+     */
+	void onHandshakeResponse(const QJsonObject& data);
+
+	/**
+     * @brief Logs the compression counters of the TcpClient.
+     */
+	void logCompressionStats() const;
+
+	static constexpr qint64 CompressionThreshold = 1024; ///< Smallest payload worth compressing.
+
+	/**
+     * @struct InFlightRequest
+     * @brief Book-keeping for a request sent but not yet answered.
+     */
+	struct InFlightRequest
+	{
+		int			  type;	 ///< The request code of the envelope.
+		QElapsedTimer timer; ///< Started when the request was handed to the TcpClient.
+	};
+
+	TcpClient*					   tcpClient;	  ///< Pointer to the TcpClient instance.
+	QHash<qint64, InFlightRequest> inFlight;	  ///< Requests awaiting a reply, keyed by RequestId.
+	qint64						   highWaterMark; ///< Outbound backlog above which backpressure is signalled.
+	const MessageCodec*			   codec;		  ///< Codec used to encode outgoing envelopes.
 };
 
 #endif					  // CLIENTHANDLER_H
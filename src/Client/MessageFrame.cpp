@@ -0,0 +1,107 @@
+/**
+ * @file MessageFrame.cpp
+ * @brief Implementation file for the MessageFrame and FrameReassembler classes.
+ */
+#include "MessageFrame.h"
+
+#include <QCryptographicHash>
+#include <QtEndian>
+#include <QDebug>
+
+QByteArray MessageFrame::encode(const QByteArray& payload, quint8 flags)
+{
+	QByteArray frame;
+	frame.reserve(HeaderSize + payload.size() + DigestSize);
+
+	char header[HeaderSize];
+	qToBigEndian<quint16>(Magic, header);
+	header[2] = static_cast<char>(Version);
+	header[3] = static_cast<char>(flags);
+	qToBigEndian<quint32>(static_cast<quint32>(payload.size()), header + 4);
+
+	frame.append(header, HeaderSize);
+	frame.append(payload);
+	frame.append(digest(payload));
+
+	return frame;
+}
+
+QByteArray MessageFrame::digest(const QByteArray& payload)
+{
+	return QCryptographicHash::hash(payload, QCryptographicHash::Sha256);
+}
+
+void FrameReassembler::append(const QByteArray& data)
+{
+	buffer.append(data);
+}
+
+FrameReassembler::Status FrameReassembler::takeFrame(QByteArray& payload, quint8& flags)
+{
+	if (bufferedBytes() < MessageFrame::HeaderSize)
+	{
+		return NeedMoreData;
+	}
+
+	const char*	  header = buffer.constData() + readPos;
+	const quint16 magic = qFromBigEndian<quint16>(header);
+	const quint8  version = static_cast<quint8>(header[2]);
+	const quint32 length = qFromBigEndian<quint32>(header + 4);
+
+	if (magic != MessageFrame::Magic || version != MessageFrame::Version || length > MessageFrame::MaxPayloadSize)
+	{
+		// The stream is out of sync, there is no reliable way to find the next frame boundary
+		qWarning() << "Invalid frame header, dropping" << bufferedBytes() << "buffered bytes";
+		clear();
+		return CorruptFrame;
+	}
+
+	const qsizetype frameSize = MessageFrame::HeaderSize + length + MessageFrame::DigestSize;
+	if (bufferedBytes() < frameSize)
+	{
+		return NeedMoreData;
+	}
+
+	const qsizetype payloadPos = readPos + MessageFrame::HeaderSize;
+	QByteArray		frameDigest = buffer.mid(payloadPos + length, MessageFrame::DigestSize);
+
+	payload = buffer.mid(payloadPos, length);
+	flags = static_cast<quint8>(header[3]);
+
+	readPos += frameSize;
+	compact();
+
+	if (MessageFrame::digest(payload) != frameDigest)
+	{
+		qWarning() << "Frame digest mismatch, dropping a" << length << "bytes frame";
+		payload.clear();
+		return CorruptFrame;
+	}
+
+	return FrameReady;
+}
+
+qsizetype FrameReassembler::bufferedBytes() const
+{
+	return buffer.size() - readPos;
+}
+
+void FrameReassembler::clear()
+{
+	buffer.clear();
+	readPos = 0;
+}
+
+void FrameReassembler::compact()
+{
+	if (readPos == buffer.size())
+	{
+		clear();
+	}
+	else if (readPos > buffer.size() / 2)
+	{
+		// Only move the tail once most of the buffer has been consumed, to keep appends amortised
+		buffer.remove(0, readPos);
+		readPos = 0;
+	}
+}
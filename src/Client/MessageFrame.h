@@ -0,0 +1,125 @@
+/**
+ * @file MessageFrame.h
+ * @brief Header file for the MessageFrame and FrameReassembler classes.
+ *
+ * This file contains the declaration of the wire framing used between the client and the server.
+ * Every message is sent as a fixed size header, followed by the payload and a trailing SHA-256 digest
+ * of the payload, so that the receiver can split a TCP byte stream back into complete messages.
+ */
+
+#ifndef MESSAGEFRAME_H
+#define MESSAGEFRAME_H
+
+#include <QByteArray>
+#include <QtGlobal>
+
+/**
+ * @class MessageFrame
+ * @brief Describes and builds a single framed message.
+ *
+ * Frame layout (all integers are big-endian):
+ * | Field   | Size     | Description                                  |
+ * |---------|----------|----------------------------------------------|
+ * | magic   | 2 bytes  | Always @ref Magic, used to detect stream desync |
+ * | version | 1 byte   | Framing version, currently @ref Version        |
+ * | flags   | 1 byte   | Per-message @ref Flag values                   |
+ * | length  | 4 bytes  | Length of the payload in bytes                 |
+ * | payload | length   | The message itself                             |
+ * | digest  | 32 bytes | SHA-256 of the payload                         |
+ */
+class MessageFrame
+{
+public:
+	static constexpr quint16   Magic = 0x4253;				  ///< "BS" marker at the start of every frame.
+	static constexpr quint8	   Version = 1;					  ///< Current framing version.
+	static constexpr qsizetype HeaderSize = 8;				  ///< Size of the frame header in bytes.
+	static constexpr qsizetype DigestSize = 32;				  ///< Size of the trailing SHA-256 digest.
+	static constexpr quint32   MaxPayloadSize = 64 * 1024 * 1024; ///< Upper bound accepted for a single payload.
+
+	/**
+     * @enum Flag
+     * @brief Bits of the flags byte of the header.
+     */
+	enum Flag : quint8
+	{
+		CborPayload = 0x01,		  ///< The payload is CBOR instead of JSON text.
+		CompressedPayload = 0x02 ///< The payload is zlib compressed, in the qCompress() format.
+	};
+
+	/**
+     * @brief Builds a complete frame around the given payload.
+     * @param payload The message to be framed.
+     * @param flags The per-message flags to store in the header.
+     * @return The header, payload and digest concatenated in a single buffer.
+     */
+	static QByteArray encode(const QByteArray& payload, quint8 flags = 0);
+
+	/**
+     * @brief Computes the digest appended to every frame.
+     * @param payload The message payload.
+     * @return The SHA-256 digest of the payload.
+     */
+	static QByteArray digest(const QByteArray& payload);
+};
+
+/**
+ * @class FrameReassembler
+ * @brief Incrementally rebuilds complete frames from a TCP byte stream.
+ *
+ * Data is appended as it arrives from the socket, in chunks of any size. Each call to takeFrame()
+ * hands out at most one complete message, so a message split across several segments is only
+ * delivered once it is complete, and several messages received together are delivered one by one.
+ */
+class FrameReassembler
+{
+public:
+	/**
+     * @enum Status
+     * @brief Result of a takeFrame() call.
+     */
+	enum Status
+	{
+		NeedMoreData, ///< No complete frame is buffered yet.
+		FrameReady,	  ///< A complete and valid frame was extracted.
+		CorruptFrame  ///< A frame was dropped because its header or digest is invalid.
+	};
+
+	/**
+     * @brief Appends data received from the socket.
+     * @param data The received bytes.
+     */
+	void append(const QByteArray& data);
+
+	/**
+     * @brief Extracts the next complete frame from the buffer, if any.
+     * @param payload Receives the frame payload when FrameReady is returned.
+     * @param flags Receives the frame flags when FrameReady is returned.
+     * @return The status of the extraction.
+     *
+     * A frame with a wrong digest is skipped and the stream continues with the next one.
+     * A wrong magic or version means the stream lost synchronisation, in which case the whole
+     * buffer is discarded.
+     */
+	Status takeFrame(QByteArray& payload, quint8& flags);
+
+	/**
+     * @brief Returns the number of bytes buffered but not yet consumed.
+     */
+	qsizetype bufferedBytes() const;
+
+	/**
+     * @brief Discards all buffered data, e.g. when the connection is closed.
+     */
+	void clear();
+
+private:
+	/**
+     * @brief Drops the consumed part of the buffer once it becomes large enough.
+     */
+	void compact();
+
+	QByteArray buffer;		 ///< Received bytes not yet handed out.
+	qsizetype  readPos = 0;	 ///< Offset of the first unconsumed byte in buffer.
+};
+
+#endif // MESSAGEFRAME_H
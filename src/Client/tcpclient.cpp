@@ -17,8 +17,12 @@
 #include <QSslConfiguration>
 
 #include <QOverload>
+#include <QTimer>
+#include <QElapsedTimer>
 
-TcpClient::TcpClient(QObject* parent) : QObject(parent)
+TcpClient::TcpClient(QObject* parent) :
+	QObject(parent), mode(FramedMode), queuedBytes(0), highWaterMark(1024 * 1024), congested(false),
+	flushScheduled(false), compressionThreshold(0)
 {
 	socket = new QTcpSocket(this);
 
@@ -29,6 +33,7 @@ TcpClient::TcpClient(QObject* parent) : QObject(parent)
 	connect(socket, &QSslSocket::errorOccurred, this, &TcpClient::onErrorOccurred);
 
 	connect(socket, &QSslSocket::disconnected, this, &TcpClient::onDisconnected);
+	connect(socket, &QSslSocket::bytesWritten, this, &TcpClient::onBytesWritten);
 }
 
 TcpClient::~TcpClient()
@@ -43,34 +48,115 @@ void TcpClient::connectToServer(const QString& host, quint16 port)
 	socket->connectToHost(host, port);
 }
 
-void TcpClient::sendTcpRequest(const QByteArray& request)
+bool TcpClient::sendTcpRequest(const QByteArray& request, quint8 flags)
 {
-	if (socket->state() == QAbstractSocket::ConnectedState)
+	if (socket->state() != QAbstractSocket::ConnectedState)
 	{
-		// Generate hash of the request
-		QCryptographicHash hash(QCryptographicHash::Sha256);
+		return false;
+	}
+
+	QByteArray dataToSend;
+
+	if (mode == FramedMode)
+	{
+		if (compressionThreshold > 0 && request.size() >= compressionThreshold)
+		{
+			QElapsedTimer timer;
+			timer.start();
+			QByteArray compressed = qCompress(request);
+
+			outboundStats.elapsedNs += timer.nsecsElapsed();
 
-		hash.addData(request);
-		QByteArray hashValue = hash.result();
+			// Incompressible payloads are sent as they are
+			if (compressed.size() < request.size())
+			{
+				outboundStats.frames++;
+				outboundStats.compressedBytes += compressed.size();
+				outboundStats.uncompressedBytes += request.size();
 
+				dataToSend = MessageFrame::encode(compressed, flags | MessageFrame::CompressedPayload);
+			}
+		}
+
+		// Header with the payload length, the payload and its hash
+		if (dataToSend.isEmpty())
+		{
+			dataToSend = MessageFrame::encode(request, flags);
+		}
+	}
+	else
+	{
 		// Append hash to the request data
-		QByteArray dataToSend = request + hashValue;
+		dataToSend = request + MessageFrame::digest(request);
+	}
+
+	queuedBytes += dataToSend.size();
+	outboundQueue.append(dataToSend);
+	updateBackpressure();
 
-		// Send the data
-		socket->write(dataToSend);
-		socket->waitForBytesWritten();
+	// Defer the write to the event loop so requests issued together leave in a single write
+	if (!flushScheduled)
+	{
+		flushScheduled = true;
+		QTimer::singleShot(0, this, &TcpClient::flushOutboundQueue);
 	}
+
+	return true;
 }
 
 void TcpClient::closeConnection()
 {
 	if (socket->isOpen())
 	{
+		// Hand everything still queued to the socket, it is flushed before the connection closes
+		while (!outboundQueue.isEmpty())
+		{
+			socket->write(outboundQueue.takeFirst());
+		}
+		queuedBytes = 0;
+
 		socket->disconnectFromHost();
 		socket->waitForDisconnected(500);
 	}
 }
 
+void TcpClient::setWireMode(WireMode mode)
+{
+	this->mode = mode;
+	reassembler.clear();
+}
+
+TcpClient::WireMode TcpClient::wireMode() const
+{
+	return mode;
+}
+
+void TcpClient::setHighWaterMark(qint64 bytes)
+{
+	highWaterMark = bytes;
+	updateBackpressure();
+}
+
+qint64 TcpClient::pendingBytes() const
+{
+	return queuedBytes + socket->bytesToWrite();
+}
+
+void TcpClient::setCompressionThreshold(qint64 bytes)
+{
+	compressionThreshold = bytes;
+}
+
+const TcpClient::CompressionStats& TcpClient::inboundCompressionStats() const
+{
+	return inboundStats;
+}
+
+const TcpClient::CompressionStats& TcpClient::outboundCompressionStats() const
+{
+	return outboundStats;
+}
+
 void TcpClient::onConnected()
 {
 	qDebug() << "Connected to server";
@@ -78,9 +164,57 @@ void TcpClient::onConnected()
 
 void TcpClient::onReadyRead()
 {
-	QByteArray response = socket->readAll();
+	if (mode == RawMode)
+	{
+		emit ResponseReadySignal(NetworkMessage::fromPayload(socket->readAll(), MessageCodec::Json));
+		return;
+	}
+
+	reassembler.append(socket->readAll());
+
+	QByteArray payload;
+	quint8	   flags = 0;
+
+	// A single read may complete several frames, or none at all
+	for (;;)
+	{
+		FrameReassembler::Status status = reassembler.takeFrame(payload, flags);
 
-	emit ResponseReadySignal(response);
+		if (status == FrameReassembler::NeedMoreData)
+		{
+			break;
+		}
+		if (status != FrameReassembler::FrameReady)
+		{
+			continue;
+		}
+
+		if (flags & MessageFrame::CompressedPayload)
+		{
+			QElapsedTimer timer;
+			timer.start();
+			QByteArray inflated = qUncompress(payload);
+
+			inboundStats.elapsedNs += timer.nsecsElapsed();
+
+			if (inflated.isEmpty())
+			{
+				qWarning() << "Failed to inflate a" << payload.size() << "bytes frame, dropping it";
+				continue;
+			}
+
+			inboundStats.frames++;
+			inboundStats.compressedBytes += payload.size();
+			inboundStats.uncompressedBytes += inflated.size();
+
+			payload = std::move(inflated);
+		}
+
+		// The payload buffer is moved into the message, which is then shared by every later stage
+		MessageCodec::Format format = (flags & MessageFrame::CborPayload) ? MessageCodec::Cbor : MessageCodec::Json;
+
+		emit ResponseReadySignal(NetworkMessage::fromPayload(std::move(payload), format));
+	}
 }
 
 void TcpClient::onErrorOccurred(QAbstractSocket::SocketError socketError)
@@ -106,5 +240,68 @@ void TcpClient::onStateChanged(QAbstractSocket::SocketState socketState)
 
 void TcpClient::onDisconnected()
 {
+	reassembler.clear();
+	clearOutboundQueue();
 	qDebug() << "Disconnected from server";
-}
\ No newline at end of file
+}
+
+void TcpClient::onBytesWritten(qint64 bytes)
+{
+	Q_UNUSED(bytes);
+
+	flushOutboundQueue();
+}
+
+void TcpClient::flushOutboundQueue()
+{
+	flushScheduled = false;
+
+	if (socket->state() != QAbstractSocket::ConnectedState)
+	{
+		return;
+	}
+
+	// Keep at most one chunk buffered in the socket, the rest is written from onBytesWritten
+	while (!outboundQueue.isEmpty() && socket->bytesToWrite() < MaxWriteChunk)
+	{
+		QByteArray chunk = outboundQueue.takeFirst();
+
+		while (!outboundQueue.isEmpty() && chunk.size() + outboundQueue.first().size() <= MaxWriteChunk)
+		{
+			chunk.append(outboundQueue.takeFirst());
+		}
+
+		queuedBytes -= chunk.size();
+		socket->write(chunk);
+	}
+
+	updateBackpressure();
+}
+
+void TcpClient::updateBackpressure()
+{
+	qint64 pending = pendingBytes();
+
+	if (!congested && pending > highWaterMark)
+	{
+		congested = true;
+		emit BackpressureSignal(true);
+	}
+	else if (congested && pending <= highWaterMark / 2)
+	{
+		congested = false;
+		emit BackpressureSignal(false);
+	}
+}
+
+void TcpClient::clearOutboundQueue()
+{
+	outboundQueue.clear();
+	queuedBytes = 0;
+
+	if (congested)
+	{
+		congested = false;
+		emit BackpressureSignal(false);
+	}
+}
@@ -15,6 +15,9 @@
 #include <QJsonObject>
 #include <QJsonDocument>
 #include <QDebug>
+#include <QList>
+#include "MessageFrame.h"
+#include "NetworkMessage.h"
 
 /**
  * @class TcpClient
@@ -23,6 +26,14 @@
  * The TcpClient class is responsible for establishing a connection to a TCP server,
  * sending requests, receiving responses, and handling various socket states and errors.
  * It provides signals for connection status and incoming responses.
+ *
+ * Outgoing messages never block the calling thread: they are appended to an outbound queue which is
+ * drained as the socket reports written bytes, merging several small frames into a single write.
+ * When the amount of unsent data exceeds the high-water mark, BackpressureSignal(true) is emitted,
+ * and BackpressureSignal(false) once it falls back under half of that mark.
+ *
+ * Frames flagged with @ref MessageFrame::CompressedPayload are inflated before ResponseReadySignal
+ * is emitted. Outgoing payloads are compressed once a compression threshold has been set.
  */
 class TcpClient : public QObject
 {
@@ -36,6 +47,36 @@ public:
      */
 	explicit TcpClient(QObject* parent = nullptr);
 
+	/**
+     * @enum WireMode
+     * @brief Defines how messages are delimited on the wire.
+     */
+	enum WireMode
+	{
+		RawMode,   ///< Legacy mode, payload followed by its digest and no length information.
+		FramedMode ///< Every message is wrapped in a @ref MessageFrame and reassembled on reception.
+	};
+
+	/**
+     * @struct CompressionStats
+     * @brief Counters describing the effect and the cost of payload compression in one direction.
+     */
+	struct CompressionStats
+	{
+		quint64 frames = 0;			   ///< Number of compressed frames.
+		quint64 compressedBytes = 0;   ///< Size of these payloads on the wire.
+		quint64 uncompressedBytes = 0; ///< Size of these payloads once inflated.
+		qint64	elapsedNs = 0;		   ///< Time spent compressing or inflating them.
+
+		/**
+         * @brief Returns the uncompressed to compressed size ratio, 1 when nothing was compressed.
+         */
+		double ratio() const
+		{
+			return compressedBytes == 0 ? 1.0 : double(uncompressedBytes) / double(compressedBytes);
+		}
+	};
+
 	/**
      * @brief Destructor for TcpClient.
      *
@@ -55,10 +96,12 @@ public:
 	/**
      * @brief Send a TCP request.
      * @param request The request data to be sent.
+     * @param flags The MessageFrame flags describing the request payload, ignored in RawMode.
+     * @return true if the request was queued for sending, false if not connected.
      *
-     * Sends the specified request to the connected server.
+     * Queues the specified request for the connected server and returns immediately.
      */
-	void sendTcpRequest(const QByteArray& request);
+	bool sendTcpRequest(const QByteArray& request, quint8 flags = 0);
 
 	/**
      * @brief Close the TCP connection.
@@ -67,12 +110,54 @@ public:
      */
 	void closeConnection();
 
+	/**
+     * @brief Set the wire mode used for both sending and receiving.
+     * @param mode The new wire mode, FramedMode by default.
+     */
+	void setWireMode(WireMode mode);
+
+	/**
+     * @brief Get the current wire mode.
+     * @return The wire mode in use.
+     */
+	WireMode wireMode() const;
+
+	/**
+     * @brief Set the amount of unsent data above which backpressure is signalled.
+     * @param bytes The high-water mark in bytes.
+     */
+	void setHighWaterMark(qint64 bytes);
+
+	/**
+     * @brief Get the number of bytes queued or buffered but not yet written to the network.
+     * @return The pending outbound bytes.
+     */
+	qint64 pendingBytes() const;
+
+	/**
+     * @brief Set the payload size from which outgoing messages are compressed.
+     * @param bytes The threshold in bytes, 0 or less disables outgoing compression.
+     */
+	void setCompressionThreshold(qint64 bytes);
+
+	/**
+     * @brief Get the compression counters of received frames.
+     */
+	const CompressionStats& inboundCompressionStats() const;
+
+	/**
+     * @brief Get the compression counters of sent frames.
+     */
+	const CompressionStats& outboundCompressionStats() const;
+
 signals:
 	/**
      * @brief Signal emitted when a response is ready.
-     * @param response The response data received from the server.
+     * @param response The response received from the server, already inflated, JSON in RawMode.
+     *
+     * In FramedMode this is emitted exactly once per complete frame, with the frame header and digest removed.
      */
-	void ResponseReadySignal(QByteArray response);
+	void ResponseReadySignal(MessagePtr response);
 
 	/**
      * @brief Signal emitted when connected to the server.
@@ -84,6 +169,12 @@ signals:
      */
 	void DisconnectedSignal();
 
+	/**
+     * @brief Signal emitted when the outbound backlog crosses the high-water mark.
+     * @param congested true when the backlog went above the mark, false once it has drained.
+     */
+	void BackpressureSignal(bool congested);
+
 private slots:
 	/**
      * @brief Slot for handling the connected state.
@@ -122,8 +213,45 @@ private slots:
      */
 	void onDisconnected();
 
+	/**
+     * @brief Slot for handling written data.
+     * @param bytes The number of bytes the socket has just written.
+     *
+     * Refills the socket from the outbound queue.
+     */
+	void onBytesWritten(qint64 bytes);
+
+	/**
+     * @brief Writes queued frames to the socket, coalescing small ones into a single write.
+     */
+	void flushOutboundQueue();
+
 private:
-	QTcpSocket* socket; ///< The TCP socket used for communication.
+	/**
+     * @brief Emits BackpressureSignal when the pending data crosses one of the water marks.
+     */
+	void updateBackpressure();
+
+	/**
+     * @brief Drops all unsent data and releases any backpressure.
+     */
+	void clearOutboundQueue();
+
+	static constexpr qint64 MaxWriteChunk = 64 * 1024; ///< Upper size of a coalesced write.
+
+	QTcpSocket*		 socket;	  ///< The TCP socket used for communication.
+	WireMode		 mode;		  ///< How messages are delimited on the wire.
+	FrameReassembler reassembler; ///< Rebuilds complete frames from the received byte stream.
+
+	QList<QByteArray> outboundQueue;  ///< Frames waiting to be written to the socket.
+	qint64			  queuedBytes;	  ///< Total size of the frames in outboundQueue.
+	qint64			  highWaterMark;  ///< Pending bytes above which backpressure is signalled.
+	bool			  congested;	  ///< Whether backpressure is currently signalled.
+	bool			  flushScheduled; ///< Whether a flush is already queued in the event loop.
+
+	qint64			 compressionThreshold; ///< Payload size from which outgoing messages are compressed.
+	CompressionStats inboundStats;		   ///< Compression counters of received frames.
+	CompressionStats outboundStats;		   ///< Compression counters of sent frames.
 };
 
 #endif // TCPCLIENT_H
\ No newline at end of file
@@ -0,0 +1,297 @@
+/**
+ * @file PagedUserTableModel.cpp
+ * @brief Implementation file for the PagedUserTableModel class.
+ */
+#include "PagedUserTableModel.h"
+
+#include <algorithm>
+
+PagedUserTableModel::PagedUserTableModel(const QVariantMap& query, QObject* parent) :
+	QAbstractTableModel(parent), query_(query), pageSize_(DefaultPageSize), fields_(UserRecord::AllFields), total_(0),
+	generation_(0),
+	pages_(DefaultMaxCachedPages), shownFirst_(-1), shownLast_(-1), requestManager(RequestManager::getInstance())
+{
+}
+
+void PagedUserTableModel::setPageSize(int rows)
+{
+	beginResetModel();
+	pageSize_ = std::max(rows, 1);
+	pages_.clear();
+	pendingRequests_.clear();
+	requestedPages_.clear();
+	endResetModel();
+}
+
+void PagedUserTableModel::setFields(quint8 fields)
+{
+	beginResetModel();
+	fields_ = fields;
+	pages_.clear();
+	pendingRequests_.clear();
+	requestedPages_.clear();
+	snapshotVersion_ = QVariant();
+	endResetModel();
+}
+
+void PagedUserTableModel::setMaxCachedPages(int pages)
+{
+	pages_.setMaxCost(pages);
+}
+
+void PagedUserTableModel::refresh()
+{
+	++generation_;
+	requestPage(0);
+
+	// Cached pages stay on screen until their reply, only the ones shown are asked for again
+	if (shownFirst_ >= 0)
+	{
+		ensureRowsLoaded(shownFirst_, shownLast_);
+	}
+}
+
+void PagedUserTableModel::ensureRowsLoaded(int first, int last)
+{
+	shownFirst_ = std::max(first, 0);
+	shownLast_ = std::max(last, shownFirst_);
+
+	const int lastRow = std::min(shownLast_, total_ - 1);
+	if (shownFirst_ > lastRow)
+	{
+		return;
+	}
+
+	for (int page = shownFirst_ / pageSize_; page <= lastRow / pageSize_; ++page)
+	{
+		const Page* cached = pages_.object(page);
+		if (cached == nullptr || cached->generation != generation_)
+		{
+			requestPage(page);
+		}
+	}
+}
+
+bool PagedUserTableModel::applyPage(const UserPage& page)
+{
+	const auto pending = pendingRequests_.constFind(page.requestId);
+	if (page.requestId == -1 || pending == pendingRequests_.constEnd())
+	{
+		return false;
+	}
+
+	const PendingRequest request = pending.value();
+	pendingRequests_.erase(pending);
+
+	if (requestedPages_.value(request.page) == request.generation)
+	{
+		requestedPages_.remove(request.page);
+	}
+
+	// A server answering with the whole database is handled by the caller
+	if (page.total < 0)
+	{
+		snapshotVersion_ = page.version;
+		return false;
+	}
+
+	snapshotVersion_ = QVariant();
+	pages_.insert(request.page, new Page{page.users, request.generation, page.version, page.fields});
+	setTotal(static_cast<int>(page.total));
+
+	const int first = request.page * pageSize_;
+	const int last = std::min(first + pageSize_, total_) - 1;
+	if (first <= last)
+	{
+		emit dataChanged(index(first, 0), index(last, UserTableModel::ColumnCount - 1));
+	}
+	return true;
+}
+
+bool PagedUserTableModel::applyNotModified(qint64 requestId)
+{
+	const auto pending = pendingRequests_.constFind(requestId);
+	if (requestId == -1 || pending == pendingRequests_.constEnd())
+	{
+		return false;
+	}
+
+	const PendingRequest request = pending.value();
+	pendingRequests_.erase(pending);
+
+	if (requestedPages_.value(request.page) == request.generation)
+	{
+		requestedPages_.remove(request.page);
+	}
+
+	// The rows shown are still current, only the page is marked as such so it is not requested again
+	Page* cached = pages_.object(request.page);
+	if (cached != nullptr && cached->generation < request.generation)
+	{
+		cached->generation = request.generation;
+	}
+	return true;
+}
+
+void PagedUserTableModel::applyChanges(const QList<UserChange>& changes)
+{
+	if (std::any_of(changes.cbegin(), changes.cend(),
+					[](const UserChange& change) { return change.kind != UserChange::Updated; }))
+	{
+		refresh();
+		return;
+	}
+
+	// Cached rows are keyed once for the whole batch
+	QHash<qint64, int>	rowOfAccount;
+	QHash<QString, int> rowOfEmail;
+	for (int number : pages_.keys())
+	{
+		const Page* page = pages_.object(number);
+		for (int offset = 0; offset < page->users.size(); ++offset)
+		{
+			const UserRecord& user = page->users.at(offset);
+			rowOfAccount.insert(user.accountNumber, number * pageSize_ + offset);
+			rowOfEmail.insert(user.email, number * pageSize_ + offset);
+		}
+	}
+
+	const auto cachedUser = [this](int row) -> UserRecord* {
+		return row < 0 ? nullptr : &pages_.object(row / pageSize_)->users[row % pageSize_];
+	};
+
+	int first = total_;
+	int last = -1;
+	for (const UserChange& change : changes)
+	{
+		for (const UserRecord& user : change.users)
+		{
+			int			row = rowOfAccount.value(user.accountNumber, -1);
+			UserRecord* shown = cachedUser(row);
+			if (shown == nullptr || !shown->isSameUser(user))
+			{
+				row = rowOfEmail.value(user.email, -1);
+				shown = cachedUser(row);
+			}
+			if (shown == nullptr || !shown->isSameUser(user))
+			{
+				continue;
+			}
+
+			shown->assignFields(user, change.fields);
+			first = std::min(first, row);
+			last = std::max(last, row);
+		}
+	}
+
+	last = std::min(last, total_ - 1);
+	if (first <= last)
+	{
+		emit dataChanged(index(first, 0), index(last, UserTableModel::ColumnCount - 1));
+	}
+}
+
+bool PagedUserTableModel::isFetching() const
+{
+	return !pendingRequests_.isEmpty();
+}
+
+const UserRecord* PagedUserTableModel::userAt(int row) const
+{
+	const Page* page = pageAt(row / pageSize_);
+	const int	offset = row % pageSize_;
+
+	if (page == nullptr || offset >= page->users.size())
+	{
+		return nullptr;
+	}
+	return &page->users.at(offset);
+}
+
+int PagedUserTableModel::rowCount(const QModelIndex& parent) const
+{
+	return parent.isValid() ? 0 : total_;
+}
+
+int PagedUserTableModel::columnCount(const QModelIndex& parent) const
+{
+	return parent.isValid() ? 0 : UserTableModel::ColumnCount;
+}
+
+QVariant PagedUserTableModel::data(const QModelIndex& index, int role) const
+{
+	if (!index.isValid() || index.row() >= total_ || index.column() >= UserTableModel::ColumnCount ||
+		role != Qt::DisplayRole)
+	{
+		return QVariant();
+	}
+
+	const Page* page = pageAt(index.row() / pageSize_);
+	const int	offset = index.row() % pageSize_;
+
+	// Fields left out of the reply are not shown with their default value
+	if (page == nullptr || offset >= page->users.size() ||
+		!(page->fields & UserTableModel::columnField(index.column())))
+	{
+		return QVariant();
+	}
+
+	return UserTableModel::displayData(page->users.at(offset), index.column());
+}
+
+QVariant PagedUserTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+	if (orientation == Qt::Horizontal && role == Qt::DisplayRole && section >= 0 &&
+		section < UserTableModel::ColumnCount)
+	{
+		return UserTableModel::columnTitle(section);
+	}
+	return QAbstractTableModel::headerData(section, orientation, role);
+}
+
+const PagedUserTableModel::Page* PagedUserTableModel::pageAt(int page) const
+{
+	return pages_.object(page);
+}
+
+void PagedUserTableModel::requestPage(int page)
+{
+	const auto requested = requestedPages_.constFind(page);
+	if (requested != requestedPages_.constEnd() && requested.value() == generation_)
+	{
+		return;
+	}
+
+	QVariantMap data = query_;
+	data.insert("offset", static_cast<qint64>(page) * pageSize_);
+	data.insert("limit", pageSize_);
+
+	// The server answers "not modified" when the copy we hold is still current
+	const Page* cached = pages_.object(page);
+	const QVariant version = cached != nullptr ? cached->version : (page == 0 ? snapshotVersion_ : QVariant());
+	if (!version.isNull())
+	{
+		data.insert("if_version", version);
+	}
+
+	requestManager->createRequest(RequestManager::GetDatabase, data,
+								  fields_ == UserRecord::AllFields ? QStringList() : UserRecord::fieldNames(fields_));
+	pendingRequests_.insert(requestManager->lastRequestId(), PendingRequest{page, generation_});
+	requestedPages_.insert(page, generation_);
+}
+
+void PagedUserTableModel::setTotal(int total)
+{
+	if (total > total_)
+	{
+		beginInsertRows(QModelIndex(), total_, total - 1);
+		total_ = total;
+		endInsertRows();
+	}
+	else if (total < total_)
+	{
+		beginRemoveRows(QModelIndex(), total, total_ - 1);
+		total_ = total;
+		endRemoveRows();
+	}
+}
@@ -0,0 +1,181 @@
+/**
+ * @file PagedUserTableModel.h
+ * @brief Header file for the PagedUserTableModel class.
+ *
+ * This file contains the declaration of the table model showing the users of the bank when the server
+ * pages GetDatabase.
+ */
+
+#ifndef PAGEDUSERTABLEMODEL_H
+#define PAGEDUSERTABLEMODEL_H
+
+#include <QAbstractTableModel>
+#include <QCache>
+#include <QHash>
+#include <QList>
+#include <QVariantMap>
+#include "RequestManager.h"
+#include "ResponseManager.h"
+#include "UserRecord.h"
+#include "UserTableModel.h"
+
+/**
+ * @class PagedUserTableModel
+ * @brief A read-only model loading the users page by page as the view shows them.
+ *
+ * The row count is the "total" sent with every page. The view reports the rows it shows with
+ * ensureRowsLoaded(), which requests the pages not cached with "offset" and "limit". data() never sends
+ * a request, a row of a page not loaded stays empty until the page arrives. Pages are kept in a least
+ * recently used cache of bounded size, so the memory used does not depend on the number of users.
+ *
+ * refresh() keeps the cached pages on screen and requests again the ones that are shown. Each request
+ * carries the "version" of the cached page as "if_version", and a "not modified" reply only marks the
+ * page as current. The version of a whole snapshot is kept as well, for servers that do not page.
+ *
+ * A view showing only some columns restricts the fields requested with setFields(), the other cells
+ * are left empty.
+ */
+class PagedUserTableModel : public QAbstractTableModel
+{
+	Q_OBJECT
+public:
+	static constexpr int DefaultPageSize = 100;		///< Number of users requested per page.
+	static constexpr int DefaultMaxCachedPages = 20; ///< Number of pages kept in memory.
+
+	/**
+	 * @brief Constructor for PagedUserTableModel.
+	 *
+	 * @param query The fields sent with every page request.
+	 * @param parent The parent QObject, default is nullptr.
+	 */
+	explicit PagedUserTableModel(const QVariantMap& query, QObject* parent = nullptr);
+
+	/**
+	 * @brief Sets the number of users requested per page, clearing the cache.
+	 */
+	void setPageSize(int rows);
+
+	/**
+	 * @brief Sets the fields requested for every user, clearing the cache.
+	 *
+	 * @param fields A combination of UserRecord::Field flags, UserRecord::AllFields by default.
+	 */
+	void setFields(quint8 fields);
+
+	/**
+	 * @brief Sets the number of pages kept in memory.
+	 */
+	void setMaxCachedPages(int pages);
+
+	/**
+	 * @brief Requests the first page again, and the pages of the rows shown.
+	 */
+	void refresh();
+
+	/**
+	 * @brief Requests the pages of the rows shown that are not cached or older than the last refresh.
+	 *
+	 * Called by the view whenever the rows it shows change. The range is kept for the next refresh.
+	 *
+	 * @param first The first row shown.
+	 * @param last The last row shown.
+	 */
+	void ensureRowsLoaded(int first, int last);
+
+	/**
+	 * @brief Applies a page received from the server.
+	 *
+	 * @param page The page, as emitted by ResponseManager::DatabaseFetched.
+	 * @return true if the page answered a request of this model and the server pages the database.
+	 */
+	bool applyPage(const UserPage& page);
+
+	/**
+	 * @brief Applies a "not modified" reply, the cached page is kept as it is.
+	 *
+	 * @param requestId The RequestId, as emitted by ResponseManager::ResultUnchanged.
+	 * @return true if the reply answered a request of this model. When the server does not page the
+	 * database, this means the snapshot shown is still current.
+	 */
+	bool applyNotModified(qint64 requestId);
+
+	/**
+	 * @brief Applies changes pushed by the server.
+	 *
+	 * Updates are applied to the cached pages in place. Created and deleted users move the rows after
+	 * them, so the model is then refreshed once for the whole batch.
+	 *
+	 * @param changes The changes, in the order they were received.
+	 */
+	void applyChanges(const QList<UserChange>& changes);
+
+	/**
+	 * @brief Tells whether page requests are in flight.
+	 */
+	bool isFetching() const;
+
+	/**
+	 * @brief Returns the user shown at a given row, or nullptr if its page is not loaded.
+	 */
+	const UserRecord* userAt(int row) const;
+
+	int		 rowCount(const QModelIndex& parent = QModelIndex()) const override;
+	int		 columnCount(const QModelIndex& parent = QModelIndex()) const override;
+	QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+	QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+private:
+	/**
+	 * @struct Page
+	 * @brief A cached page.
+	 */
+	struct Page
+	{
+		QList<UserRecord> users;	  ///< The users of the page.
+		quint64			  generation; ///< Value of generation_ when the page was last known current.
+		QVariant		  version;	  ///< "version" sent with the page, null if none.
+		quint8			  fields;	  ///< UserRecord::Field flags of the fields sent.
+	};
+
+	/**
+	 * @struct PendingRequest
+	 * @brief A page request in flight.
+	 */
+	struct PendingRequest
+	{
+		int		page;		///< The requested page.
+		quint64 generation; ///< Value of generation_ when the page was requested.
+	};
+
+	/**
+	 * @brief Returns a cached page, marking it as recently used, or nullptr.
+	 *
+	 * A page older than the last refresh is returned as well, it is requested again by ensureRowsLoaded().
+	 */
+	const Page* pageAt(int page) const;
+
+	/**
+	 * @brief Sends a page request unless one is already in flight for this refresh.
+	 */
+	void requestPage(int page);
+
+	/**
+	 * @brief Resizes the table to a new total, keeping the rows in common.
+	 */
+	void setTotal(int total);
+
+	QVariantMap						query_;			  ///< Fields sent with every page request.
+	int								pageSize_;		  ///< Number of users per page.
+	quint8							fields_;		  ///< UserRecord::Field flags of the fields requested.
+	int								total_;			  ///< Number of rows.
+	quint64							generation_;	  ///< Incremented by every refresh.
+	mutable QCache<int, Page>		pages_;			  ///< Cached pages, by page number.
+	QVariant						snapshotVersion_; ///< "version" of the last whole snapshot, null if none.
+	QHash<qint64, PendingRequest>	pendingRequests_; ///< Request in flight of each RequestId.
+	QHash<int, quint64>				requestedPages_;  ///< Generation of the last request in flight per page.
+	int								shownFirst_;	  ///< First row shown by the view, -1 if none.
+	int								shownLast_;		  ///< Last row shown by the view, -1 if none.
+	RequestManager*					requestManager;	  ///< The request manager for handling server requests.
+};
+
+#endif // PAGEDUSERTABLEMODEL_H
@@ -0,0 +1,391 @@
+/**
+ * @file SortableTableModel.cpp
+ * @brief Implementation file for the SortableTableModel class.
+ */
+#include "SortableTableModel.h"
+
+#include <QThread>
+#include <QtConcurrent>
+#include <algorithm>
+#include <numeric>
+#include <utility>
+
+namespace
+{
+/// Below this number of rows the order is sorted on a single thread.
+constexpr int ParallelSortThreshold = 1 << 14;
+
+/**
+ * @struct RowLess
+ * @brief Compares two source rows by their keys, then by position.
+ */
+struct RowLess
+{
+	const QList<SortableTableModel::SortKey>* keys;
+
+	bool operator()(int a, int b) const
+	{
+		for (const auto& key : *keys)
+		{
+			int result = 0;
+			if (!key.texts.isEmpty())
+			{
+				result = key.texts.at(a).compare(key.texts.at(b));
+			}
+			else
+			{
+				const qint64 x = key.integers.at(a);
+				const qint64 y = key.integers.at(b);
+				result = (x > y) - (x < y);
+			}
+
+			if (result != 0)
+			{
+				return key.order == Qt::AscendingOrder ? result < 0 : result > 0;
+			}
+		}
+		return a < b;
+	}
+};
+
+/**
+ * @struct Range
+ * @brief A range of positions of the order being sorted.
+ */
+struct Range
+{
+	int begin;
+	int middle; ///< End of the first half when merging two sorted halves.
+	int end;
+};
+} // namespace
+
+SortableTableModel::SortableTableModel(QObject* parent) :
+	QAbstractTableModel(parent), permuted_(false), watcher_(new QFutureWatcher<QList<int>>(this)), generation_(0),
+	sortGeneration_(0)
+{
+	connect(watcher_, &QFutureWatcher<QList<int>>::finished, this, &SortableTableModel::applySortedOrder);
+}
+
+void SortableTableModel::sort(int column, Qt::SortOrder order)
+{
+	sortByColumns({SortColumn{column, order}});
+}
+
+void SortableTableModel::sortByColumns(const QList<SortColumn>& columns)
+{
+	sortColumns_ = columns;
+	++generation_;
+
+	if (!columns.isEmpty())
+	{
+		startSort();
+		return;
+	}
+
+	if (permuted_)
+	{
+		applyOrder(QList<int>());
+	}
+	emit sorted();
+}
+
+void SortableTableModel::toggleSortColumn(int column, bool addToSort)
+{
+	QList<SortColumn> columns = addToSort ? sortColumns_ : QList<SortColumn>();
+
+	const auto current = std::find_if(sortColumns_.cbegin(), sortColumns_.cend(),
+									  [column](const SortColumn& sortColumn) { return sortColumn.column == column; });
+	const Qt::SortOrder order = current != sortColumns_.cend() && current->order == Qt::AscendingOrder
+									? Qt::DescendingOrder
+									: Qt::AscendingOrder;
+
+	auto existing = std::find_if(columns.begin(), columns.end(),
+								 [column](const SortColumn& sortColumn) { return sortColumn.column == column; });
+	if (existing != columns.end())
+	{
+		existing->order = order;
+	}
+	else
+	{
+		columns.append(SortColumn{column, order});
+	}
+	sortByColumns(columns);
+}
+
+const QList<SortableTableModel::SortColumn>& SortableTableModel::sortColumns() const
+{
+	return sortColumns_;
+}
+
+int SortableTableModel::sourceRow(int row) const
+{
+	return permuted_ ? order_.at(row) : row;
+}
+
+int SortableTableModel::viewRow(int sourceRow) const
+{
+	return permuted_ ? positions_.at(sourceRow) : sourceRow;
+}
+
+QList<int> SortableTableModel::sortedOrder(const QList<SortKey>& keys, int rows)
+{
+	QList<int> order(rows);
+	std::iota(order.begin(), order.end(), 0);
+
+	const RowLess less{&keys};
+	const int	  threads = QThread::idealThreadCount();
+
+	if (rows < ParallelSortThreshold || threads < 2)
+	{
+		std::sort(order.begin(), order.end(), less);
+		return order;
+	}
+
+	// Sort one chunk per thread, then merge the sorted chunks pairwise, each level in parallel
+	QList<Range> ranges;
+	for (int chunk = 0; chunk < threads; ++chunk)
+	{
+		const int begin = static_cast<int>(static_cast<qint64>(rows) * chunk / threads);
+		const int end = static_cast<int>(static_cast<qint64>(rows) * (chunk + 1) / threads);
+		ranges.append(Range{begin, end, end});
+	}
+
+	int* data = order.data();
+	QtConcurrent::blockingMap(ranges, [data, less](Range& range) { std::sort(data + range.begin, data + range.end, less); });
+
+	while (ranges.size() > 1)
+	{
+		QList<Range> merged;
+		for (qsizetype i = 0; i + 1 < ranges.size(); i += 2)
+		{
+			merged.append(Range{ranges.at(i).begin, ranges.at(i).end, ranges.at(i + 1).end});
+		}
+
+		QtConcurrent::blockingMap(merged, [data, less](Range& range) {
+			std::inplace_merge(data + range.begin, data + range.middle, data + range.end, less);
+		});
+
+		if (ranges.size() % 2 != 0)
+		{
+			merged.append(ranges.last());
+		}
+		for (Range& range : merged)
+		{
+			range.middle = range.end;
+		}
+		ranges = merged;
+	}
+	return order;
+}
+
+int SortableTableModel::rowCount(const QModelIndex& parent) const
+{
+	if (parent.isValid())
+	{
+		return 0;
+	}
+	return permuted_ ? static_cast<int>(order_.size()) : sourceRowCount();
+}
+
+void SortableTableModel::resetOrder()
+{
+	clearOrder();
+	++generation_;
+	startSort();
+}
+
+void SortableTableModel::prependRows(int count)
+{
+	if (permuted_)
+	{
+		QList<int> order(count);
+		std::iota(order.begin(), order.end(), 0);
+		for (int row : std::as_const(order_))
+		{
+			order.append(row + count);
+		}
+		setOrder(order);
+	}
+	++generation_;
+	startSort();
+}
+
+void SortableTableModel::appendRows(int count)
+{
+	if (permuted_)
+	{
+		const int first = static_cast<int>(order_.size());
+		for (int row = first; row < first + count; ++row)
+		{
+			order_.append(row);
+			positions_.append(row);
+		}
+	}
+	++generation_;
+	startSort();
+}
+
+void SortableTableModel::removeSourceRows(const QList<int>& sourceRows,
+										  const std::function<void(const QList<int>&)>& erase)
+{
+	if (sourceRows.isEmpty())
+	{
+		return;
+	}
+
+	// Removing from an explicit permutation keeps the remaining shown rows valid until the data is erased
+	const bool sortedBefore = permuted_;
+	if (!sortedBefore)
+	{
+		QList<int> identity(sourceRowCount());
+		std::iota(identity.begin(), identity.end(), 0);
+		setOrder(identity);
+	}
+
+	QList<int> shown;
+	shown.reserve(sourceRows.size());
+	for (int row : sourceRows)
+	{
+		shown.append(positions_.at(row));
+	}
+	std::sort(shown.begin(), shown.end());
+
+	// Remove the ranges from the bottom up so that the rows above keep their positions
+	for (qsizetype last = shown.size() - 1; last >= 0;)
+	{
+		qsizetype first = last;
+		while (first > 0 && shown.at(first - 1) == shown.at(first) - 1)
+		{
+			--first;
+		}
+
+		beginRemoveRows(QModelIndex(), shown.at(first), shown.at(last));
+		order_.remove(shown.at(first), last - first + 1);
+		endRemoveRows();
+
+		last = first - 1;
+	}
+
+	erase(sourceRows);
+
+	QList<int> order;
+	order.reserve(order_.size());
+	for (int row : std::as_const(order_))
+	{
+		const auto removedBefore = std::lower_bound(sourceRows.cbegin(), sourceRows.cend(), row) - sourceRows.cbegin();
+		order.append(row - static_cast<int>(removedBefore));
+	}
+
+	if (sortedBefore)
+	{
+		setOrder(order);
+	}
+	else
+	{
+		clearOrder();
+	}
+	++generation_;
+	startSort();
+}
+
+void SortableTableModel::sourceRowsChanged(const QList<int>& sourceRows)
+{
+	const int lastColumn = columnCount() - 1;
+	for (int row : sourceRows)
+	{
+		const int shown = viewRow(row);
+		emit dataChanged(index(shown, 0), index(shown, lastColumn));
+	}
+
+	if (!sourceRows.isEmpty())
+	{
+		++generation_;
+		startSort();
+	}
+}
+
+void SortableTableModel::applySortedOrder()
+{
+	// A result computed for rows that have changed since is dropped, a new sort is already running
+	if (sortGeneration_ != generation_ || sortColumns_.isEmpty())
+	{
+		return;
+	}
+
+	const QList<int> order = watcher_->result();
+	if (order.size() != sourceRowCount())
+	{
+		return;
+	}
+
+	applyOrder(order);
+	emit sorted();
+}
+
+void SortableTableModel::startSort()
+{
+	if (sortColumns_.isEmpty())
+	{
+		return;
+	}
+
+	const SortKeyBuilder build = sortKeys(sortColumns_);
+	const int			 rows = sourceRowCount();
+
+	sortGeneration_ = generation_;
+	watcher_->setFuture(QtConcurrent::run([build, rows]() { return sortedOrder(build(), rows); }));
+}
+
+void SortableTableModel::applyOrder(const QList<int>& order)
+{
+	emit layoutAboutToBeChanged({}, QAbstractItemModel::VerticalSortHint);
+
+	QList<int> positions(order.size());
+	for (int row = 0; row < order.size(); ++row)
+	{
+		positions[order.at(row)] = row;
+	}
+
+	// Persistent indexes, such as the selection, follow their rows to the new positions
+	const QModelIndexList from = persistentIndexList();
+	QModelIndexList		  to;
+	to.reserve(from.size());
+	for (const QModelIndex& index : from)
+	{
+		const int source = sourceRow(index.row());
+		to.append(this->index(positions.isEmpty() ? source : positions.at(source), index.column()));
+	}
+	changePersistentIndexList(from, to);
+
+	if (order.isEmpty())
+	{
+		clearOrder();
+	}
+	else
+	{
+		order_ = order;
+		positions_ = positions;
+		permuted_ = true;
+	}
+
+	emit layoutChanged({}, QAbstractItemModel::VerticalSortHint);
+}
+
+void SortableTableModel::setOrder(const QList<int>& order)
+{
+	permuted_ = true;
+	order_ = order;
+	positions_.resize(order.size());
+	for (int row = 0; row < order.size(); ++row)
+	{
+		positions_[order.at(row)] = row;
+	}
+}
+
+void SortableTableModel::clearOrder()
+{
+	permuted_ = false;
+	order_.clear();
+	positions_.clear();
+}
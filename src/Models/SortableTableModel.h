@@ -0,0 +1,215 @@
+/**
+ * @file SortableTableModel.h
+ * @brief Header file for the SortableTableModel class.
+ *
+ * This file contains the declaration of the base of the table models that can be sorted by one or
+ * more columns.
+ */
+
+#ifndef SORTABLETABLEMODEL_H
+#define SORTABLETABLEMODEL_H
+
+#include <QAbstractTableModel>
+#include <QFutureWatcher>
+#include <QList>
+#include <QString>
+#include <functional>
+
+/**
+ * @class SortableTableModel
+ * @brief A table model presenting its rows through a sorted permutation.
+ *
+ * Derived models keep their rows in the order they were received and address them by source row.
+ * Sorting never moves the rows: a worker thread computes typed sort keys and sorts an array of row
+ * numbers in parallel, and the resulting permutation is applied with a layout change.
+ *
+ * Derived models call sourceRow() to read the row shown at a position, and tell the base about
+ * resets and insertions so that the permutation stays valid and is recomputed.
+ */
+class SortableTableModel : public QAbstractTableModel
+{
+	Q_OBJECT
+public:
+	/**
+	 * @struct SortColumn
+	 * @brief One column of a sort, the first one being the primary.
+	 */
+	struct SortColumn
+	{
+		int			  column; ///< The column.
+		Qt::SortOrder order;  ///< The direction.
+	};
+
+	/**
+	 * @struct SortKey
+	 * @brief The precomputed keys of one sorted column, indexed by source row.
+	 *
+	 * Only one of the lists is filled, texts are compared as they are, so they should be case folded.
+	 */
+	struct SortKey
+	{
+		QList<qint64>  integers; ///< Numeric keys.
+		QList<QString> texts;	 ///< Text keys.
+		Qt::SortOrder  order = Qt::AscendingOrder; ///< The direction.
+	};
+
+	/**
+	 * @brief Builds the keys of a sort. Runs on a worker thread, so it may only use captured copies.
+	 */
+	using SortKeyBuilder = std::function<QList<SortKey>()>;
+
+	/**
+	 * @brief Constructor for SortableTableModel.
+	 *
+	 * @param parent The parent QObject, default is nullptr.
+	 */
+	explicit SortableTableModel(QObject* parent = nullptr);
+
+	/**
+	 * @brief Sorts by a single column.
+	 */
+	void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
+
+	/**
+	 * @brief Sorts by several columns, an empty list restores the received order.
+	 */
+	void sortByColumns(const QList<SortColumn>& columns);
+
+	/**
+	 * @brief Sorts by a column as asked by a click on its header.
+	 *
+	 * A column already sorted has its direction reversed, any other column is sorted in ascending order.
+	 *
+	 * @param column The clicked column.
+	 * @param addToSort Whether the column is added to the current sort instead of replacing it.
+	 */
+	void toggleSortColumn(int column, bool addToSort);
+
+	/**
+	 * @brief Returns the columns of the current sort.
+	 */
+	const QList<SortColumn>& sortColumns() const;
+
+	/**
+	 * @brief Returns the number of rows shown, which the derived models do not override.
+	 */
+	int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+
+	/**
+	 * @brief Returns the source row shown at a given row.
+	 */
+	int sourceRow(int row) const;
+
+	/**
+	 * @brief Returns the row at which a given source row is shown.
+	 */
+	int viewRow(int sourceRow) const;
+
+	/**
+	 * @brief Sorts an array of row numbers by the given keys, in parallel for large tables.
+	 *
+	 * Rows with equal keys keep their source order.
+	 *
+	 * @param keys The keys of every sorted column.
+	 * @param rows The number of rows.
+	 * @return The source row of every sorted position.
+	 */
+	static QList<int> sortedOrder(const QList<SortKey>& keys, int rows);
+
+signals:
+	/**
+	 * @brief Signal emitted when a sort has been applied.
+	 */
+	void sorted();
+
+protected:
+	/**
+	 * @brief Returns the number of rows held by the derived model.
+	 */
+	virtual int sourceRowCount() const = 0;
+
+	/**
+	 * @brief Returns the builder of the keys of a sort.
+	 *
+	 * @param columns The sorted columns, never empty.
+	 */
+	virtual SortKeyBuilder sortKeys(const QList<SortColumn>& columns) const = 0;
+
+	/**
+	 * @brief Forgets the permutation, to be called between beginResetModel() and endResetModel(),
+	 * once the new rows are set.
+	 *
+	 * The current sort is computed again for the new rows.
+	 */
+	void resetOrder();
+
+	/**
+	 * @brief Accounts for source rows added in front of the others, to be called between
+	 * beginInsertRows() and endInsertRows(), once the rows are added.
+	 *
+	 * The new rows are shown at the top until the current sort is computed again, so the derived model
+	 * inserts them at rows 0 to count - 1.
+	 */
+	void prependRows(int count);
+
+	/**
+	 * @brief Accounts for source rows added after the others, to be called between
+	 * beginInsertRows() and endInsertRows(), once the rows are added.
+	 *
+	 * The new rows are shown at the bottom until the current sort is computed again.
+	 */
+	void appendRows(int count);
+
+	/**
+	 * @brief Removes source rows, notifying the views of every contiguous range of shown rows.
+	 *
+	 * The rows are first removed from the permutation, then erase is called to remove them from the
+	 * data of the derived model, after which the remaining source rows are renumbered.
+	 *
+	 * @param sourceRows The rows to remove, in ascending order.
+	 * @param erase Removes the given source rows from the data of the derived model.
+	 */
+	void removeSourceRows(const QList<int>& sourceRows, const std::function<void(const QList<int>&)>& erase);
+
+	/**
+	 * @brief Notifies the views that source rows have changed, to be called once they are updated.
+	 */
+	void sourceRowsChanged(const QList<int>& sourceRows);
+
+private slots:
+	/**
+	 * @brief Applies the permutation computed by the worker thread.
+	 */
+	void applySortedOrder();
+
+private:
+	/**
+	 * @brief Starts sorting the current rows by sortColumns_, if any.
+	 */
+	void startSort();
+
+	/**
+	 * @brief Replaces the permutation with a layout change, an empty order restores the source order.
+	 */
+	void applyOrder(const QList<int>& order);
+
+	/**
+	 * @brief Replaces the permutation without notifying the views.
+	 */
+	void setOrder(const QList<int>& order);
+
+	/**
+	 * @brief Shows the source rows in their own order, without notifying the views.
+	 */
+	void clearOrder();
+
+	QList<SortColumn>			sortColumns_; ///< Columns of the current sort.
+	bool						permuted_;	  ///< Whether the rows are shown through order_.
+	QList<int>					order_;		  ///< Source row of every shown row.
+	QList<int>					positions_;	  ///< Shown row of every source row.
+	QFutureWatcher<QList<int>>* watcher_;	  ///< Watches the sort in progress.
+	quint64						generation_;  ///< Incremented whenever the rows change.
+	quint64						sortGeneration_; ///< Generation of the rows being sorted.
+};
+
+#endif // SORTABLETABLEMODEL_H
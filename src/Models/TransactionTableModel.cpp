@@ -0,0 +1,309 @@
+/**
+ * @file TransactionTableModel.cpp
+ * @brief Implementation file for the TransactionTableModel class.
+ */
+#include "TransactionTableModel.h"
+
+namespace
+{
+/// Header titles of each column, in Column order.
+const char* const columnTitles[TransactionTableModel::ColumnCount] = {"From Account", "To Account", "Amount",
+																	  "Date of Transaction"};
+} // namespace
+
+TransactionTableModel::TransactionTableModel(const QVariantMap& query, QObject* parent) :
+	SortableTableModel(parent), query_(query), pageSize_(DefaultPageSize), hasMore_(false), loaded_(false),
+	pendingNewestRequest_(-1), pendingOlderRequest_(-1), requestManager(RequestManager::getInstance())
+{
+}
+
+void TransactionTableModel::setPageSize(int rows)
+{
+	pageSize_ = rows;
+}
+
+void TransactionTableModel::refresh()
+{
+	// A refresh already in flight will bring the same transactions
+	if (pendingNewestRequest_ != -1)
+	{
+		return;
+	}
+
+	if (rows_.isEmpty())
+	{
+		pendingNewestRequest_ = requestPage(QVariant());
+		return;
+	}
+
+	pendingNewestRequest_ = requestPage(QVariant(), rows_.createdAts().at(0), version_);
+}
+
+bool TransactionTableModel::applyNotModified(qint64 requestId)
+{
+	if (requestId == -1 || requestId != pendingNewestRequest_)
+	{
+		return false;
+	}
+
+	// The rows shown are still the newest ones, nothing to apply
+	pendingNewestRequest_ = -1;
+	emit refreshed(0);
+	return true;
+}
+
+bool TransactionTableModel::applyPage(const TransactionPage& page)
+{
+	if (page.requestId != -1 && page.requestId == pendingOlderRequest_)
+	{
+		pendingOlderRequest_ = -1;
+		applyOlderPage(page);
+		return true;
+	}
+
+	// Replies without a RequestId can only be matched to the refresh
+	if (pendingNewestRequest_ != -1 && (page.requestId == pendingNewestRequest_ || page.requestId == -1))
+	{
+		pendingNewestRequest_ = -1;
+		applyNewestPage(page);
+		return true;
+	}
+	return false;
+}
+
+void TransactionTableModel::applyPushed(const TransactionPage& page)
+{
+	if (!loaded_)
+	{
+		return;
+	}
+
+	version_ = page.version;
+	applyDelta(page);
+}
+
+bool TransactionTableModel::hasLoaded() const
+{
+	return loaded_;
+}
+
+int TransactionTableModel::sourceRowCount() const
+{
+	return static_cast<int>(rows_.size());
+}
+
+int TransactionTableModel::columnCount(const QModelIndex& parent) const
+{
+	return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant TransactionTableModel::data(const QModelIndex& index, int role) const
+{
+	if (!index.isValid() || index.row() >= rowCount() || index.column() >= ColumnCount)
+	{
+		return QVariant();
+	}
+
+	if (role != Qt::DisplayRole)
+	{
+		return QVariant();
+	}
+
+	// Text is only built for the cells being painted
+	const qsizetype row = sourceRow(index.row());
+	switch (index.column())
+	{
+		case FromAccount:
+			return QString::number(rows_.fromAccounts().at(row));
+		case ToAccount:
+			return QString::number(rows_.toAccounts().at(row));
+		case Amount:
+			return TransactionStore::formatAmount(rows_.amountsCents().at(row));
+		case CreatedAt:
+			return TransactionStore::formatTimestamp(rows_.createdAts().at(row));
+		default:
+			return QVariant();
+	}
+}
+
+QVariant TransactionTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+	if (orientation == Qt::Horizontal && role == Qt::DisplayRole && section >= 0 && section < ColumnCount)
+	{
+		return QString(columnTitles[section]);
+	}
+	return SortableTableModel::headerData(section, orientation, role);
+}
+
+bool TransactionTableModel::canFetchMore(const QModelIndex& parent) const
+{
+	return !parent.isValid() && hasMore_ && pendingOlderRequest_ == -1;
+}
+
+void TransactionTableModel::fetchMore(const QModelIndex& parent)
+{
+	if (!canFetchMore(parent))
+	{
+		return;
+	}
+
+	pendingOlderRequest_ = requestPage(nextCursor_);
+}
+
+qint64 TransactionTableModel::requestPage(const QVariant& cursor, qint64 since, const QVariant& version)
+{
+	QVariantMap data = query_;
+	data.insert("limit", pageSize_);
+
+	if (!cursor.isNull())
+	{
+		data.insert("cursor", cursor);
+	}
+	if (since != TransactionStore::InvalidTimestamp)
+	{
+		// A UTC instant, whatever the server's time zone. Dates finer than a millisecond are rounded down,
+		// so the newest transaction comes back and is dropped by applyDelta() rather than missed
+		data.insert("since", TransactionStore::formatIsoTimestamp(since));
+	}
+	if (!version.isNull())
+	{
+		data.insert("if_version", version);
+	}
+
+	requestManager->createRequest(RequestManager::GetTransactionsHistory, data);
+	return requestManager->lastRequestId();
+}
+
+void TransactionTableModel::applyNewestPage(const TransactionPage& page)
+{
+	version_ = page.version;
+
+	if (page.isDelta && !rows_.isEmpty() && applyDelta(page))
+	{
+		return;
+	}
+
+	qsizetype known = rows_.isEmpty() ? -1 : page.rows.indexOf(rows_.at(0));
+
+	if (known < 0)
+	{
+		// First load, or more new transactions than a page: start over from this page
+		resetToPage(page);
+		return;
+	}
+
+	if (known > 0)
+	{
+		beginInsertRows(QModelIndex(), 0, static_cast<int>(known) - 1);
+		TransactionStore rows = page.rows.first(known);
+		rows.append(rows_);
+		rows_ = rows;
+		prependRows(static_cast<int>(known));
+		endInsertRows();
+	}
+
+	emit refreshed(static_cast<int>(known));
+}
+
+bool TransactionTableModel::applyDelta(const TransactionPage& page)
+{
+	// More new transactions than a page, the ones in between are missing
+	if (page.hasMore)
+	{
+		return false;
+	}
+
+	// "since" is inclusive, drop the transactions of that date already shown
+	TransactionStore fresh;
+	for (qsizetype i = 0; i < page.rows.size(); ++i)
+	{
+		const TransactionStore::Row row = page.rows.at(i);
+		bool						shown = false;
+
+		for (qsizetype j = 0; !shown && j < rows_.size() && rows_.createdAts().at(j) >= row.createdAt; ++j)
+		{
+			shown = rows_.at(j) == row;
+		}
+		if (!shown)
+		{
+			fresh.append(row);
+		}
+	}
+
+	const int added = static_cast<int>(fresh.size());
+	if (added > 0)
+	{
+		beginInsertRows(QModelIndex(), 0, added - 1);
+		fresh.append(rows_);
+		rows_ = fresh;
+		prependRows(added);
+		endInsertRows();
+	}
+
+	emit refreshed(added);
+	return true;
+}
+
+void TransactionTableModel::resetToPage(const TransactionPage& page)
+{
+	beginResetModel();
+	loaded_ = true;
+	rows_ = page.rows;
+	nextCursor_ = page.nextCursor;
+	hasMore_ = page.hasMore;
+	// A pending older page would continue from a cursor that no longer applies
+	pendingOlderRequest_ = -1;
+	resetOrder();
+	endResetModel();
+
+	emit refreshed(static_cast<int>(rows_.size()));
+}
+
+void TransactionTableModel::applyOlderPage(const TransactionPage& page)
+{
+	nextCursor_ = page.nextCursor;
+	hasMore_ = page.hasMore;
+
+	if (page.rows.isEmpty())
+	{
+		return;
+	}
+
+	const int first = static_cast<int>(rows_.size());
+	beginInsertRows(QModelIndex(), first, first + static_cast<int>(page.rows.size()) - 1);
+	rows_.append(page.rows);
+	appendRows(static_cast<int>(page.rows.size()));
+	endInsertRows();
+}
+
+SortableTableModel::SortKeyBuilder TransactionTableModel::sortKeys(const QList<SortColumn>& columns) const
+{
+	const TransactionStore rows = rows_;
+
+	return [rows, columns]()
+	{
+		QList<SortKey> keys;
+		for (const SortColumn& column : columns)
+		{
+			SortKey key;
+			key.order = column.order;
+			switch (column.column)
+			{
+				case FromAccount:
+					key.integers = rows.fromAccounts();
+					break;
+				case ToAccount:
+					key.integers = rows.toAccounts();
+					break;
+				case Amount:
+					key.integers = rows.amountsCents();
+					break;
+				default:
+					key.integers = rows.createdAts();
+					break;
+			}
+			keys.append(key);
+		}
+		return keys;
+	};
+}
@@ -0,0 +1,170 @@
+/**
+ * @file TransactionTableModel.h
+ * @brief Header file for the TransactionTableModel class.
+ *
+ * This file contains the declaration of the table model showing the transaction history of an account,
+ * loaded page by page from the server.
+ */
+
+#ifndef TRANSACTIONTABLEMODEL_H
+#define TRANSACTIONTABLEMODEL_H
+
+#include <QVariantMap>
+#include "RequestManager.h"
+#include "ResponseManager.h"
+#include "SortableTableModel.h"
+
+/**
+ * @class TransactionTableModel
+ * @brief A read-only, incrementally loaded model of the transaction history.
+ *
+ * refresh() asks the server for the newest page only, with "since" set to the date of the newest
+ * transaction shown, as an ISO 8601 UTC date with milliseconds. Servers supporting it echo "since"
+ * and only send the transactions made from that date on. Transactions newer than the ones already
+ * shown are inserted at the top without resetting the view, and the model is only reset when the gap
+ * is larger than a page. Older pages are requested through fetchMore() when the view scrolls to the
+ * end, using the cursor sent with the previous page.
+ *
+ * The "version" of the newest page is sent back as "if_version" by refresh(), so that the server can
+ * answer with a "not modified" reply when no transaction was made since.
+ *
+ * Transactions pushed by the server are inserted at the top like the reply to a refresh.
+ *
+ * Replies are told apart by their RequestId, replies to requests made by someone else are ignored.
+ *
+ * The columns of the store are used as sort keys as they are.
+ */
+class TransactionTableModel : public SortableTableModel
+{
+	Q_OBJECT
+public:
+	/**
+	 * @enum Column
+	 * @brief Defines the columns of the table, in display order.
+	 */
+	enum Column
+	{
+		FromAccount, ///< Account the money was sent from.
+		ToAccount,	 ///< Account the money was sent to.
+		Amount,		 ///< Transferred amount.
+		CreatedAt,	 ///< Date of the transaction.
+		ColumnCount	 ///< Number of columns.
+	};
+
+	static constexpr int DefaultPageSize = 50; ///< Number of transactions requested per page.
+
+	/**
+	 * @brief Constructor for TransactionTableModel.
+	 *
+	 * @param query Extra fields sent with every page request, the account being the session's one by default.
+	 * @param parent The parent QObject, default is nullptr.
+	 */
+	explicit TransactionTableModel(const QVariantMap& query, QObject* parent = nullptr);
+
+	/**
+	 * @brief Sets the number of transactions requested per page.
+	 *
+	 * @param rows The page size.
+	 */
+	void setPageSize(int rows);
+
+	/**
+	 * @brief Requests the newest page, to pick up transactions made since the last refresh.
+	 */
+	void refresh();
+
+	/**
+	 * @brief Applies a page received from the server.
+	 *
+	 * @param page The page, as emitted by ResponseManager::TransactionsFetched.
+	 * @return true if the page answered a request of this model.
+	 */
+	bool applyPage(const TransactionPage& page);
+
+	/**
+	 * @brief Applies a "not modified" reply, the rows shown are kept as they are.
+	 *
+	 * @param requestId The RequestId, as emitted by ResponseManager::ResultUnchanged.
+	 * @return true if the reply answered the refresh of this model.
+	 */
+	bool applyNotModified(qint64 requestId);
+
+	/**
+	 * @brief Inserts transactions pushed by the server, skipping those already shown.
+	 *
+	 * Pushes received before the first page are dropped, that page brings them.
+	 *
+	 * @param page The page, as emitted by ResponseManager::TransactionsPushed.
+	 */
+	void applyPushed(const TransactionPage& page);
+
+	/**
+	 * @brief Tells whether a first page has been applied.
+	 */
+	bool hasLoaded() const;
+
+	int		 columnCount(const QModelIndex& parent = QModelIndex()) const override;
+	QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+	QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+	bool	 canFetchMore(const QModelIndex& parent) const override;
+	void	 fetchMore(const QModelIndex& parent) override;
+
+signals:
+	/**
+	 * @brief Signal emitted when the reply to refresh() has been applied.
+	 *
+	 * @param newRows Number of transactions that were not shown before.
+	 */
+	void refreshed(int newRows);
+
+protected:
+	int			   sourceRowCount() const override;
+	SortKeyBuilder sortKeys(const QList<SortColumn>& columns) const override;
+
+private:
+	/**
+	 * @brief Sends a page request.
+	 *
+	 * @param cursor The cursor of the page, null for the newest page.
+	 * @param since Date from which transactions are wanted, InvalidTimestamp for a whole page.
+	 * @param version Version of the rows shown, null to always get a page back.
+	 * @return The RequestId of the request.
+	 */
+	qint64 requestPage(const QVariant& cursor, qint64 since = TransactionStore::InvalidTimestamp,
+					   const QVariant& version = QVariant());
+
+	/**
+	 * @brief Applies a reply holding only the transactions since the newest one shown.
+	 *
+	 * @return false if the reply leaves a gap, the caller then starts over from the page.
+	 */
+	bool applyDelta(const TransactionPage& page);
+
+	/**
+	 * @brief Replaces every row with a page.
+	 */
+	void resetToPage(const TransactionPage& page);
+
+	/**
+	 * @brief Applies the reply to refresh().
+	 */
+	void applyNewestPage(const TransactionPage& page);
+
+	/**
+	 * @brief Applies the reply to fetchMore().
+	 */
+	void applyOlderPage(const TransactionPage& page);
+
+	QVariantMap					  query_;				///< Fields sent with every page request.
+	int							  pageSize_;			///< Number of transactions per page.
+	TransactionStore			  rows_;				///< Transactions shown, newest first.
+	QVariant					  nextCursor_;			///< Cursor of the next older page.
+	bool						  hasMore_;				///< Whether older pages exist.
+	QVariant					  version_;				///< "version" of the last newest page, null if not sent.
+	bool						  loaded_;				///< Whether a first page has been applied.
+	qint64						  pendingNewestRequest_; ///< RequestId of the refresh in flight, -1 if none.
+	qint64						  pendingOlderRequest_;	///< RequestId of the fetchMore in flight, -1 if none.
+	RequestManager*				  requestManager;		///< The request manager for handling server requests.
+};
+
+#endif // TRANSACTIONTABLEMODEL_H
@@ -0,0 +1,113 @@
+/**
+ * @file UserKeys.cpp
+ * @brief Implementation file for the UserKeys class.
+ */
+#include "UserKeys.h"
+
+#include <algorithm>
+
+namespace
+{
+template <typename Key>
+bool insertKey(QHash<Key, int>& rows, const Key& key, int row)
+{
+	if (rows.contains(key))
+	{
+		return false;
+	}
+	rows.insert(key, row);
+	return true;
+}
+
+template <typename Key>
+void removeKey(QHash<Key, int>& rows, const Key& key, int row)
+{
+	const auto it = rows.find(key);
+	if (it != rows.end() && it.value() == row)
+	{
+		rows.erase(it);
+	}
+}
+
+template <typename Key>
+void renumber(QHash<Key, int>& rows, const QList<int>& removed)
+{
+	for (auto it = rows.begin(); it != rows.end(); ++it)
+	{
+		it.value() -= static_cast<int>(std::lower_bound(removed.cbegin(), removed.cend(), it.value()) - removed.cbegin());
+	}
+}
+} // namespace
+
+UserKeys::UserKeys() : unique_(true)
+{
+}
+
+UserKeys::UserKeys(const QList<UserRecord>& users) : unique_(true)
+{
+	byAccount_.reserve(users.size());
+	for (int row = 0; row < users.size(); ++row)
+	{
+		unique_ = add(users.at(row), row) && unique_;
+	}
+}
+
+int UserKeys::find(const UserRecord& user) const
+{
+	return hasAccount(user) ? byAccount_.value(user.accountNumber, -1) : byEmail_.value(user.email, -1);
+}
+
+bool UserKeys::add(const UserRecord& user, int row)
+{
+	return hasAccount(user) ? insertKey(byAccount_, user.accountNumber, row) : insertKey(byEmail_, user.email, row);
+}
+
+void UserKeys::remove(const UserRecord& user, int row)
+{
+	if (hasAccount(user))
+	{
+		removeKey(byAccount_, user.accountNumber, row);
+	}
+	else
+	{
+		removeKey(byEmail_, user.email, row);
+	}
+}
+
+void UserKeys::rekey(const UserRecord& before, const UserRecord& after, int row)
+{
+	if (!sameKey(before, after))
+	{
+		remove(before, row);
+		add(after, row);
+	}
+}
+
+void UserKeys::removeRows(const QList<int>& rows)
+{
+	if (rows.isEmpty())
+	{
+		return;
+	}
+	renumber(byAccount_, rows);
+	renumber(byEmail_, rows);
+}
+
+bool UserKeys::isUnique() const
+{
+	return unique_;
+}
+
+bool UserKeys::sameKey(const UserRecord& a, const UserRecord& b)
+{
+	if (hasAccount(a) != hasAccount(b))
+	{
+		return false;
+	}
+	return hasAccount(a) ? a.accountNumber == b.accountNumber : a.email == b.email;
+}
+
+bool UserKeys::hasAccount(const UserRecord& user)
+{
+	return user.role != UserRecord::Admin && user.accountNumber > 0;
+}
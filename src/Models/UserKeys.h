@@ -0,0 +1,92 @@
+/**
+ * @file UserKeys.h
+ * @brief Header file for the UserKeys class.
+ *
+ * This file contains the declaration of the lookup from the key of a user to its row, used by the
+ * user models to match snapshots and pushed changes with the rows they show.
+ */
+
+#ifndef USERKEYS_H
+#define USERKEYS_H
+
+#include <QHash>
+#include <QList>
+#include <QString>
+#include "UserRecord.h"
+
+/**
+ * @class UserKeys
+ * @brief Finds the row of a user by its key.
+ *
+ * Users are keyed by account number, admins and users without an account by email.
+ */
+class UserKeys
+{
+public:
+	/**
+	 * @brief Constructs an empty lookup.
+	 */
+	UserKeys();
+
+	/**
+	 * @brief Indexes every row of a snapshot.
+	 *
+	 * @param users The users, in row order.
+	 */
+	explicit UserKeys(const QList<UserRecord>& users);
+
+	/**
+	 * @brief Returns the row of the user with the same key, or -1.
+	 */
+	int find(const UserRecord& user) const;
+
+	/**
+	 * @brief Adds the key of a user at a row.
+	 *
+	 * @return false if the key is already used, the lookup is then left unchanged.
+	 */
+	bool add(const UserRecord& user, int row);
+
+	/**
+	 * @brief Removes the key of a user, if it points to the given row.
+	 */
+	void remove(const UserRecord& user, int row);
+
+	/**
+	 * @brief Moves a row to the key of its new content, when an edit changed it.
+	 *
+	 * @param before The user as it was.
+	 * @param after The user as it is now.
+	 * @param row The row of the user.
+	 */
+	void rekey(const UserRecord& before, const UserRecord& after, int row);
+
+	/**
+	 * @brief Renumbers the rows after rows removed, whose keys must already be removed.
+	 *
+	 * @param rows The removed rows, in ascending order.
+	 */
+	void removeRows(const QList<int>& rows);
+
+	/**
+	 * @brief Tells whether no two users indexed at construction share a key.
+	 */
+	bool isUnique() const;
+
+	/**
+	 * @brief Tells whether two records have the same key.
+	 */
+	static bool sameKey(const UserRecord& a, const UserRecord& b);
+
+private:
+	/**
+	 * @brief Tells whether a user is keyed by account number rather than by email.
+	 */
+	static bool hasAccount(const UserRecord& user);
+
+	QHash<qint64, int>	byAccount_; ///< Rows of the users with an account.
+	QHash<QString, int> byEmail_;	///< Rows of the other users.
+	bool				unique_;	///< Whether no two users share a key.
+};
+
+#endif // USERKEYS_H
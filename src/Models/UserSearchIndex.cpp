@@ -0,0 +1,231 @@
+/**
+ * @file UserSearchIndex.cpp
+ * @brief Implementation file for the UserSearchIndex class.
+ */
+#include "UserSearchIndex.h"
+
+#include <QSet>
+#include <algorithm>
+#include <utility>
+
+namespace
+{
+/// Up to this number of changed rows, keys are erased one at a time rather than in a pass over the index.
+constexpr qsizetype FewRows = 16;
+} // namespace
+
+void UserSearchIndex::reset(const QList<UserRecord>& users)
+{
+	rows_.clear();
+	rows_.reserve(users.size());
+	byAccount_.clear();
+	byAccount_.reserve(users.size());
+	byPrefix_.clear();
+	byPrefix_.reserve(users.size() * 3);
+
+	QList<Entry> added;
+	added.reserve(users.size() * 3);
+	for (int row = 0; row < users.size(); ++row)
+	{
+		rows_.append(RowKeys());
+		addRow(users.at(row), row, added);
+	}
+	mergeRows(added);
+}
+
+void UserSearchIndex::applyEdit(const QList<UserRecord>& users, const UserTableModel::RowEdit& edit)
+{
+	const qsizetype touched = edit.changed.size() + edit.removed.size() + edit.appended;
+	if (edit.reset || rows_.isEmpty() || touched > users.size() / 8)
+	{
+		reset(users);
+		return;
+	}
+
+	// The old keys are dropped with the rows numbered as before the removal
+	if (edit.removed.isEmpty() && edit.changed.size() <= FewRows)
+	{
+		for (int row : edit.changed)
+		{
+			removeRow(row);
+		}
+	}
+	else
+	{
+		removeRows(edit.changed, edit.removed);
+	}
+
+	QList<Entry> added;
+	for (int row : edit.changed)
+	{
+		const auto removedBefore =
+			std::lower_bound(edit.removed.cbegin(), edit.removed.cend(), row) - edit.removed.cbegin();
+		const int current = row - static_cast<int>(removedBefore);
+		addRow(users.at(current), current, added);
+	}
+	for (int row = static_cast<int>(rows_.size()); row < users.size(); ++row)
+	{
+		rows_.append(RowKeys());
+		addRow(users.at(row), row, added);
+	}
+	mergeRows(added);
+}
+
+QList<int> UserSearchIndex::find(QStringView query, int limit) const
+{
+	QList<int> rows;
+	query = query.trimmed();
+
+	if (query.isEmpty() || limit <= 0)
+	{
+		return rows;
+	}
+
+	const bool numeric = std::all_of(query.begin(), query.end(), [](QChar c) { return c.isDigit(); });
+	if (numeric)
+	{
+		const auto it = byAccount_.constFind(query.toLongLong());
+		if (it != byAccount_.constEnd())
+		{
+			rows.append(it.value());
+		}
+		return rows;
+	}
+
+	// A user may match through several keys, the walk stops at the limit-th distinct row
+	const QString prefix = query.toString().toCaseFolded();
+	QSet<int>	  found;
+	for (auto it = std::lower_bound(byPrefix_.cbegin(), byPrefix_.cend(), Entry{prefix, -1});
+		 it != byPrefix_.cend() && rows.size() < limit && it->key.startsWith(prefix); ++it)
+	{
+		if (!found.contains(it->row))
+		{
+			found.insert(it->row);
+			rows.append(it->row);
+		}
+	}
+
+	std::sort(rows.begin(), rows.end());
+	return rows;
+}
+
+qsizetype UserSearchIndex::size() const
+{
+	return rows_.size();
+}
+
+UserSearchIndex::RowKeys UserSearchIndex::keysOf(const UserRecord& user)
+{
+	RowKeys keys{user.accountNumber, {}};
+	if (!user.email.isEmpty())
+	{
+		keys.prefixes.append(user.email.toCaseFolded());
+	}
+	if (!user.firstName.isEmpty())
+	{
+		keys.prefixes.append(user.firstName.toCaseFolded());
+	}
+	if (!user.lastName.isEmpty())
+	{
+		keys.prefixes.append(user.lastName.toCaseFolded());
+	}
+	return keys;
+}
+
+void UserSearchIndex::addRow(const UserRecord& user, int row, QList<Entry>& added)
+{
+	RowKeys& keys = rows_[row];
+	keys = keysOf(user);
+
+	// Admins have no account, they would all share account number 0
+	if (keys.accountNumber > 0)
+	{
+		byAccount_.insert(keys.accountNumber, row);
+	}
+	for (const QString& key : std::as_const(keys.prefixes))
+	{
+		added.append(Entry{key, row});
+	}
+}
+
+void UserSearchIndex::removeRow(int row)
+{
+	const RowKeys& keys = rows_.at(row);
+	if (byAccount_.value(keys.accountNumber, -1) == row)
+	{
+		byAccount_.remove(keys.accountNumber);
+	}
+
+	for (const QString& key : keys.prefixes)
+	{
+		const auto it = std::lower_bound(byPrefix_.begin(), byPrefix_.end(), Entry{key, row});
+		if (it != byPrefix_.end() && it->key == key && it->row == row)
+		{
+			byPrefix_.erase(it);
+		}
+	}
+}
+
+void UserSearchIndex::removeRows(const QList<int>& changed, const QList<int>& removed)
+{
+	QList<int> stale = changed + removed;
+	std::sort(stale.begin(), stale.end());
+
+	const auto isStale = [&stale](int row) { return std::binary_search(stale.cbegin(), stale.cend(), row); };
+	const auto renumbered = [&removed](int row)
+	{ return row - static_cast<int>(std::lower_bound(removed.cbegin(), removed.cend(), row) - removed.cbegin()); };
+
+	for (int row : std::as_const(stale))
+	{
+		const qint64 accountNumber = rows_.at(row).accountNumber;
+		if (byAccount_.value(accountNumber, -1) == row)
+		{
+			byAccount_.remove(accountNumber);
+		}
+	}
+	byPrefix_.erase(std::remove_if(byPrefix_.begin(), byPrefix_.end(),
+								   [&isStale](const Entry& entry) { return isStale(entry.row); }),
+					byPrefix_.end());
+
+	if (removed.isEmpty())
+	{
+		return;
+	}
+
+	// Renumbering keeps the order of the entries, so the array does not need sorting again
+	for (Entry& entry : byPrefix_)
+	{
+		entry.row = renumbered(entry.row);
+	}
+	for (auto it = byAccount_.begin(); it != byAccount_.end(); ++it)
+	{
+		it.value() = renumbered(it.value());
+	}
+
+	qsizetype kept = 0;
+	qsizetype next = 0;
+	for (qsizetype row = 0; row < rows_.size(); ++row)
+	{
+		if (next < removed.size() && removed.at(next) == row)
+		{
+			++next;
+			continue;
+		}
+		if (kept != row)
+		{
+			rows_[kept] = std::move(rows_[row]);
+		}
+		++kept;
+	}
+	rows_.resize(kept);
+}
+
+void UserSearchIndex::mergeRows(QList<Entry>& added)
+{
+	// Sorting the few new keys then merging them is linear in the size of the index
+	std::sort(added.begin(), added.end());
+
+	const qsizetype middle = byPrefix_.size();
+	byPrefix_.append(added);
+	std::inplace_merge(byPrefix_.begin(), byPrefix_.begin() + middle, byPrefix_.end());
+}
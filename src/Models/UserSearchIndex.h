@@ -0,0 +1,125 @@
+/**
+ * @file UserSearchIndex.h
+ * @brief Header file for the UserSearchIndex class.
+ *
+ * This file contains the declaration of the lookup structures used to find a user in the
+ * AdminWidget database tab.
+ */
+
+#ifndef USERSEARCHINDEX_H
+#define USERSEARCHINDEX_H
+
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QStringView>
+#include "UserRecord.h"
+#include "UserTableModel.h"
+
+/**
+ * @class UserSearchIndex
+ * @brief Indexes a snapshot of users by account number, email and names.
+ *
+ * Account numbers are looked up in a hash. Emails and names are kept case folded in one sorted
+ * array, so that every key starting with a prefix is a contiguous range found by binary search.
+ *
+ * applyEdit() only re-indexes the rows touched by the model: the keys of the changed and removed
+ * rows are dropped, the rows after a removed one are renumbered, and the new keys are merged in.
+ */
+class UserSearchIndex
+{
+public:
+	/**
+	 * @brief Indexes a new snapshot from scratch.
+	 *
+	 * @param users The users, in model source row order.
+	 */
+	void reset(const QList<UserRecord>& users);
+
+	/**
+	 * @brief Follows the rows touched in the model.
+	 *
+	 * @param users The users of the model once edited, in source row order.
+	 * @param edit The rows touched, as returned by the model.
+	 */
+	void applyEdit(const QList<UserRecord>& users, const UserTableModel::RowEdit& edit);
+
+	/**
+	 * @brief Finds the users matching a query.
+	 *
+	 * A query made of digits matches the account number exactly, any other query matches the start of
+	 * the email or of the first or last name, ignoring case, like a bare term of a UserSearchQuery.
+	 *
+	 * @param query The text typed by the admin.
+	 * @param limit Maximum number of rows returned, the walk stops once that many are found.
+	 * @return The first matching rows in key order, sorted by row.
+	 */
+	QList<int> find(QStringView query, int limit) const;
+
+	/**
+	 * @brief Returns the number of indexed users.
+	 */
+	qsizetype size() const;
+
+private:
+	/**
+	 * @struct Entry
+	 * @brief One key of the prefix index.
+	 */
+	struct Entry
+	{
+		QString key; ///< Case folded email or name.
+		int		row; ///< Row of the user.
+
+		bool operator<(const Entry& other) const
+		{
+			return key < other.key || (key == other.key && row < other.row);
+		}
+	};
+
+	/**
+	 * @struct RowKeys
+	 * @brief The keys a row is indexed under, kept so that they can be dropped when the row changes.
+	 */
+	struct RowKeys
+	{
+		qint64		   accountNumber; ///< Account number of the user.
+		QList<QString> prefixes;	  ///< Case folded email and names, when set.
+	};
+
+	/**
+	 * @brief Returns the keys of a user.
+	 */
+	static RowKeys keysOf(const UserRecord& user);
+
+	/**
+	 * @brief Indexes a row, appending its prefix keys to added instead of inserting them in order.
+	 */
+	void addRow(const UserRecord& user, int row, QList<Entry>& added);
+
+	/**
+	 * @brief Removes the keys of a row, which keeps its number.
+	 */
+	void removeRow(int row);
+
+	/**
+	 * @brief Removes the keys of changed and removed rows in one pass, and renumbers the rows after
+	 * the removed ones.
+	 *
+	 * @param changed Rows whose keys are dropped, which keep their number.
+	 * @param removed Rows removed from the model, in ascending order.
+	 */
+	void removeRows(const QList<int>& changed, const QList<int>& removed);
+
+	/**
+	 * @brief Merges keys appended by addRow() into the sorted prefix array.
+	 */
+	void mergeRows(QList<Entry>& added);
+
+	// The index keeps its own keys rather than sharing the model's records, which the model edits in place
+	QList<RowKeys>	   rows_;	   ///< Keys of every row.
+	QHash<qint64, int> byAccount_; ///< Row of each account number.
+	QList<Entry>	   byPrefix_;  ///< Emails and names, sorted.
+};
+
+#endif // USERSEARCHINDEX_H
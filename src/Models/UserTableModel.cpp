@@ -0,0 +1,336 @@
+/**
+ * @file UserTableModel.cpp
+ * @brief Implementation file for the UserTableModel class.
+ */
+#include "UserTableModel.h"
+#include "TransactionStore.h"
+
+#include <QSet>
+#include <algorithm>
+#include <utility>
+
+namespace
+{
+/// Header titles of each column, in Column order.
+const char* const columnTitles[UserTableModel::ColumnCount] = {"Account Number", "First Name", "Last Name",
+															   "Email",			 "Role",	   "Balance"};
+} // namespace
+
+UserTableModel::UserTableModel(QObject* parent) : SortableTableModel(parent)
+{
+}
+
+UserTableModel::RowEdit UserTableModel::setUsers(const QList<UserRecord>& users)
+{
+	RowEdit edit;
+	edit.reset = true;
+
+	if (users_.isEmpty() || users.isEmpty())
+	{
+		resetUsers(users);
+		return edit;
+	}
+
+	const UserKeys incoming(users);
+	if (!incoming.isUnique())
+	{
+		resetUsers(users);
+		return edit;
+	}
+
+	QList<int>	removed;
+	QList<int>	changed;
+	QList<bool> matched(users.size(), false);
+
+	for (int row = 0; row < users_.size(); ++row)
+	{
+		const int next = incoming.find(users_.at(row));
+		if (next < 0 || matched.at(next))
+		{
+			removed.append(row);
+			continue;
+		}
+
+		matched[next] = true;
+		if (!(users_.at(row) == users.at(next)))
+		{
+			changed.append(row);
+		}
+	}
+
+	const qsizetype added = matched.count(false);
+	if (removed.size() + changed.size() + added > users_.size() / 2)
+	{
+		resetUsers(users);
+		return edit;
+	}
+
+	// Rows are updated in place before any row moves, so the changed source rows are still valid
+	for (int row : std::as_const(changed))
+	{
+		users_[row] = users.at(incoming.find(users_.at(row)));
+	}
+	sourceRowsChanged(changed);
+
+	removeSourceRows(removed, [this](const QList<int>& rows) { eraseUsers(rows); });
+
+	if (added > 0)
+	{
+		const int first = static_cast<int>(users_.size());
+		beginInsertRows(QModelIndex(), first, first + static_cast<int>(added) - 1);
+		for (int next = 0; next < users.size(); ++next)
+		{
+			if (!matched.at(next))
+			{
+				users_.append(users.at(next));
+			}
+		}
+		appendRows(static_cast<int>(added));
+		endInsertRows();
+	}
+
+	keys_ = UserKeys(users_);
+
+	edit.reset = false;
+	edit.changed = changed;
+	edit.removed = removed;
+	edit.appended = static_cast<int>(added);
+	return edit;
+}
+
+UserTableModel::RowEdit UserTableModel::applyChanges(const QList<UserChange>& changes, bool addCreated)
+{
+	RowEdit			  edit;
+	QSet<int>		  deleted;
+	QList<UserRecord> created;
+	QList<bool>		  dropped;
+	UserKeys		  createdKeys;
+
+	// Changes are applied in the order they were pushed, a user may be created then updated
+	for (const UserChange& change : changes)
+	{
+		for (const UserRecord& user : change.users)
+		{
+			const int row = keys_.find(user);
+			if (row >= 0)
+			{
+				if (change.kind == UserChange::Deleted)
+				{
+					deleted.insert(row);
+				}
+				else if (!deleted.contains(row))
+				{
+					const UserRecord before = users_.at(row);
+					users_[row].assignFields(user, change.fields);
+					keys_.rekey(before, users_.at(row), row);
+					edit.changed.append(row);
+				}
+				continue;
+			}
+
+			const int pending = createdKeys.find(user);
+			if (pending >= 0)
+			{
+				if (change.kind == UserChange::Deleted)
+				{
+					dropped[pending] = true;
+				}
+				else if (!dropped.at(pending))
+				{
+					created[pending].assignFields(user, change.fields);
+				}
+			}
+			else if (change.kind == UserChange::Created && addCreated)
+			{
+				createdKeys.add(user, static_cast<int>(created.size()));
+				created.append(user);
+				dropped.append(false);
+			}
+		}
+	}
+
+	// Only the rows touched are notified, whatever the number of users
+	std::sort(edit.changed.begin(), edit.changed.end());
+	edit.changed.erase(std::unique(edit.changed.begin(), edit.changed.end()), edit.changed.end());
+	edit.changed.erase(std::remove_if(edit.changed.begin(), edit.changed.end(),
+									  [&deleted](int row) { return deleted.contains(row); }),
+					   edit.changed.end());
+	sourceRowsChanged(edit.changed);
+
+	edit.removed = QList<int>(deleted.cbegin(), deleted.cend());
+	std::sort(edit.removed.begin(), edit.removed.end());
+	for (int row : std::as_const(edit.removed))
+	{
+		keys_.remove(users_.at(row), row);
+	}
+	removeSourceRows(edit.removed, [this](const QList<int>& rows) { eraseUsers(rows); });
+	keys_.removeRows(edit.removed);
+
+	for (qsizetype i = 0; i < created.size(); ++i)
+	{
+		if (dropped.at(i))
+		{
+			continue;
+		}
+		if (edit.appended == 0)
+		{
+			const int first = static_cast<int>(users_.size());
+			const int count = static_cast<int>(dropped.count(false));
+			beginInsertRows(QModelIndex(), first, first + count - 1);
+		}
+		keys_.add(created.at(i), static_cast<int>(users_.size()));
+		users_.append(created.at(i));
+		++edit.appended;
+	}
+	if (edit.appended > 0)
+	{
+		appendRows(edit.appended);
+		endInsertRows();
+	}
+	return edit;
+}
+
+const QList<UserRecord>& UserTableModel::users() const
+{
+	return users_;
+}
+
+void UserTableModel::resetUsers(const QList<UserRecord>& users)
+{
+	beginResetModel();
+	users_ = users;
+	keys_ = UserKeys(users_);
+	resetOrder();
+	endResetModel();
+}
+
+void UserTableModel::eraseUsers(const QList<int>& rows)
+{
+	qsizetype kept = 0;
+	qsizetype next = 0;
+	for (qsizetype row = 0; row < users_.size(); ++row)
+	{
+		if (next < rows.size() && rows.at(next) == row)
+		{
+			++next;
+			continue;
+		}
+		if (kept != row)
+		{
+			users_[kept] = std::move(users_[row]);
+		}
+		++kept;
+	}
+	users_.erase(users_.begin() + kept, users_.end());
+}
+
+const UserRecord& UserTableModel::userAt(int row) const
+{
+	return users_.at(sourceRow(row));
+}
+
+int UserTableModel::sourceRowCount() const
+{
+	return static_cast<int>(users_.size());
+}
+
+int UserTableModel::columnCount(const QModelIndex& parent) const
+{
+	return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant UserTableModel::data(const QModelIndex& index, int role) const
+{
+	if (!index.isValid() || index.row() >= rowCount() || index.column() >= ColumnCount)
+	{
+		return QVariant();
+	}
+
+	if (role != Qt::DisplayRole)
+	{
+		return QVariant();
+	}
+
+	return displayData(users_.at(sourceRow(index.row())), index.column());
+}
+
+QVariant UserTableModel::displayData(const UserRecord& user, int column)
+{
+	switch (column)
+	{
+		case AccountNumber:
+			return QString::number(user.accountNumber);
+		case FirstName:
+			return user.firstName;
+		case LastName:
+			return user.lastName;
+		case Email:
+			return user.email;
+		case Role:
+			return UserRecord::roleName(user.role);
+		case Balance:
+			return TransactionStore::formatAmount(user.balanceCents);
+		default:
+			return QVariant();
+	}
+}
+
+QString UserTableModel::columnTitle(int column)
+{
+	return QString(columnTitles[column]);
+}
+
+UserRecord::Field UserTableModel::columnField(int column)
+{
+	// The columns are in the order of the field flags
+	return static_cast<UserRecord::Field>(1 << column);
+}
+
+QVariant UserTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+	if (orientation == Qt::Horizontal && role == Qt::DisplayRole && section >= 0 && section < ColumnCount)
+	{
+		return columnTitle(section);
+	}
+	return SortableTableModel::headerData(section, orientation, role);
+}
+
+SortableTableModel::SortKeyBuilder UserTableModel::sortKeys(const QList<SortColumn>& columns) const
+{
+	// The snapshot is shared with the worker, which is left alone if the model is reset meanwhile
+	const QList<UserRecord> users = users_;
+
+	return [users, columns]()
+	{
+		QList<SortKey> keys;
+		for (const SortColumn& column : columns)
+		{
+			SortKey key;
+			key.order = column.order;
+
+			if (column.column == FirstName || column.column == LastName || column.column == Email)
+			{
+				key.texts.reserve(users.size());
+				for (const UserRecord& user : users)
+				{
+					const QString& text = column.column == FirstName
+											  ? user.firstName
+											  : (column.column == LastName ? user.lastName : user.email);
+					key.texts.append(text.toCaseFolded());
+				}
+			}
+			else
+			{
+				key.integers.reserve(users.size());
+				for (const UserRecord& user : users)
+				{
+					key.integers.append(column.column == AccountNumber ? user.accountNumber
+										: column.column == Role		   ? user.role
+																	   : user.balanceCents);
+				}
+			}
+			keys.append(key);
+		}
+		return keys;
+	};
+}
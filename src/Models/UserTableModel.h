@@ -0,0 +1,147 @@
+/**
+ * @file UserTableModel.h
+ * @brief Header file for the UserTableModel class.
+ *
+ * This file contains the declaration of the table model showing the users of the bank in the
+ * AdminWidget database tab.
+ */
+
+#ifndef USERTABLEMODEL_H
+#define USERTABLEMODEL_H
+
+#include <QList>
+#include "ResponseManager.h"
+#include "SortableTableModel.h"
+#include "UserKeys.h"
+#include "UserRecord.h"
+
+/**
+ * @class UserTableModel
+ * @brief A read-only model over the rows of a GetDatabase reply.
+ *
+ * The model keeps the record list it is given, shared with the decoded reply, and produces cell text
+ * only when a view asks for it. Together with a QTableView using fixed row heights, only the visible
+ * rows are ever looked at, whatever the number of users.
+ *
+ * Sorting compares integer accounts and balances and case folded names and emails.
+ */
+class UserTableModel : public SortableTableModel
+{
+	Q_OBJECT
+public:
+	/**
+	 * @enum Column
+	 * @brief Defines the columns of the table, in display order.
+	 */
+	enum Column
+	{
+		AccountNumber, ///< Account number of the user.
+		FirstName,	   ///< First name of the user.
+		LastName,	   ///< Last name of the user.
+		Email,		   ///< Email of the user.
+		Role,		   ///< "user" or "admin".
+		Balance,	   ///< Balance of the account.
+		ColumnCount	   ///< Number of columns.
+	};
+
+	/**
+	 * @struct RowEdit
+	 * @brief The source rows touched by setUsers() or applyChanges(), for the structures indexing them.
+	 *
+	 * Rows are updated in place first, then removed, then added at the end.
+	 */
+	struct RowEdit
+	{
+		bool	   reset = false; ///< Whether every row was replaced, the other members are then empty.
+		QList<int> changed;		  ///< Rows updated in place, numbered as before the removal.
+		QList<int> removed;		  ///< Rows removed, in ascending order.
+		int		   appended = 0;  ///< Number of rows added at the end.
+	};
+
+	/**
+	 * @brief Constructor for UserTableModel.
+	 *
+	 * @param parent The parent QObject, default is nullptr.
+	 */
+	explicit UserTableModel(QObject* parent = nullptr);
+
+	/**
+	 * @brief Replaces the content of the model with a new snapshot.
+	 *
+	 * The snapshot is matched to the current rows by account number, or by email for users without an
+	 * account. Only the rows that were removed, changed or added are notified, so the selection and
+	 * the scroll position are kept. New users are added at the end.
+	 *
+	 * The model is reset instead on the first snapshot, when keys are not unique or when most rows differ.
+	 *
+	 * @param users The rows, as emitted by ResponseManager::DatabaseFetched.
+	 * @return The rows touched.
+	 */
+	RowEdit setUsers(const QList<UserRecord>& users);
+
+	/**
+	 * @brief Applies changes pushed by the server to the rows, notifying only the rows changed.
+	 *
+	 * Users are found through the key index kept by the model and patched in place, so the cost follows
+	 * the number of changes rather than the number of users, apart from compacting the rows removed.
+	 *
+	 * @param changes The changes, in the order they were received.
+	 * @param addCreated Whether created users are added, a view of search results only updates the users it shows.
+	 * @return The rows touched.
+	 */
+	RowEdit applyChanges(const QList<UserChange>& changes, bool addCreated = true);
+
+	/**
+	 * @brief Returns the rows in source order, as indexed by sourceRow().
+	 */
+	const QList<UserRecord>& users() const;
+
+	/**
+	 * @brief Returns the user shown at a given row.
+	 *
+	 * @param row The row number, as shown, which must be valid.
+	 * @return The user record.
+	 */
+	const UserRecord& userAt(int row) const;
+
+	/**
+	 * @brief Returns the text shown for a user in a given column.
+	 */
+	static QVariant displayData(const UserRecord& user, int column);
+
+	/**
+	 * @brief Returns the header title of a column.
+	 */
+	static QString columnTitle(int column);
+
+	/**
+	 * @brief Returns the UserRecord::Field flag of the field shown in a column.
+	 */
+	static UserRecord::Field columnField(int column);
+
+	int		 columnCount(const QModelIndex& parent = QModelIndex()) const override;
+	QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+	QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+protected:
+	int			   sourceRowCount() const override;
+	SortKeyBuilder sortKeys(const QList<SortColumn>& columns) const override;
+
+private:
+	/**
+	 * @brief Replaces every row with a model reset.
+	 */
+	void resetUsers(const QList<UserRecord>& users);
+
+	/**
+	 * @brief Removes source rows from users_, keeping the order of the others.
+	 *
+	 * @param rows The rows to remove, in ascending order.
+	 */
+	void eraseUsers(const QList<int>& rows);
+
+	QList<UserRecord> users_; ///< The records shown by the model.
+	UserKeys		  keys_;  ///< Source row of every user, kept up to date by every edit.
+};
+
+#endif // USERTABLEMODEL_H
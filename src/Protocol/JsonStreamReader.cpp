@@ -0,0 +1,453 @@
+/**
+ * @file JsonStreamReader.cpp
+ * @brief Implementation file for the JsonStreamReader class.
+ */
+#include "JsonStreamReader.h"
+
+#include <cstring>
+#include <QtAlgorithms>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define JSONSTREAMREADER_SSE2
+#endif
+
+namespace
+{
+/**
+ * @brief Finds the next '"' or '\\' in [p, end).
+ *
+ * @return The position found, or end.
+ */
+const char* findQuoteOrBackslash(const char* p, const char* end)
+{
+#ifdef JSONSTREAMREADER_SSE2
+	const __m128i quote = _mm_set1_epi8('"');
+	const __m128i backslash = _mm_set1_epi8('\\');
+
+	for (; end - p >= 16; p += 16)
+	{
+		const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+		const int	  mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)));
+		if (mask != 0)
+		{
+			return p + qCountTrailingZeroBits(static_cast<uint>(mask));
+		}
+	}
+#endif
+	for (; p < end; ++p)
+	{
+		if (*p == '"' || *p == '\\')
+		{
+			return p;
+		}
+	}
+	return end;
+}
+
+/**
+ * @brief Finds the next '"', '{', '}', '[' or ']' in [p, end).
+ *
+ * @return The position found, or end.
+ */
+const char* findStructural(const char* p, const char* end)
+{
+#ifdef JSONSTREAMREADER_SSE2
+	const __m128i quote = _mm_set1_epi8('"');
+	const __m128i openBrace = _mm_set1_epi8('{');
+	const __m128i closeBrace = _mm_set1_epi8('}');
+	const __m128i openBracket = _mm_set1_epi8('[');
+	const __m128i closeBracket = _mm_set1_epi8(']');
+
+	for (; end - p >= 16; p += 16)
+	{
+		const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+		__m128i		  hits = _mm_cmpeq_epi8(chunk, quote);
+		hits = _mm_or_si128(hits, _mm_cmpeq_epi8(chunk, openBrace));
+		hits = _mm_or_si128(hits, _mm_cmpeq_epi8(chunk, closeBrace));
+		hits = _mm_or_si128(hits, _mm_cmpeq_epi8(chunk, openBracket));
+		hits = _mm_or_si128(hits, _mm_cmpeq_epi8(chunk, closeBracket));
+
+		const int mask = _mm_movemask_epi8(hits);
+		if (mask != 0)
+		{
+			return p + qCountTrailingZeroBits(static_cast<uint>(mask));
+		}
+	}
+#endif
+	for (; p < end; ++p)
+	{
+		switch (*p)
+		{
+			case '"':
+			case '{':
+			case '}':
+			case '[':
+			case ']':
+				return p;
+			default:
+				break;
+		}
+	}
+	return end;
+}
+
+/**
+ * @brief Parses four hexadecimal digits of a \\u escape.
+ *
+ * @return The code unit, or -1 if the digits are invalid.
+ */
+int parseHex4(const char* p)
+{
+	int value = 0;
+	for (int i = 0; i < 4; ++i)
+	{
+		const char c = p[i];
+		value <<= 4;
+		if (c >= '0' && c <= '9')
+		{
+			value |= c - '0';
+		}
+		else if (c >= 'a' && c <= 'f')
+		{
+			value |= c - 'a' + 10;
+		}
+		else if (c >= 'A' && c <= 'F')
+		{
+			value |= c - 'A' + 10;
+		}
+		else
+		{
+			return -1;
+		}
+	}
+	return value;
+}
+} // namespace
+
+JsonStreamReader::JsonStreamReader(QByteArrayView document) :
+	begin(document.data()),
+	end(document.data() + document.size()),
+	pos(document.data()),
+	tokenBegin(document.data()),
+	tokenEnd(document.data()),
+	valueBegin(document.data()),
+	current(Invalid),
+	escaped(false),
+	expectName(false)
+{
+}
+
+JsonStreamReader::Token JsonStreamReader::readNext()
+{
+	if (current == Invalid && pos != begin)
+	{
+		return Invalid;
+	}
+
+	for (;;)
+	{
+		skipWhitespace();
+		if (pos == end)
+		{
+			current = nesting.isEmpty() ? EndOfDocument : fail();
+			return current;
+		}
+
+		valueBegin = pos;
+		const char c = *pos;
+
+		switch (c)
+		{
+			case ',':
+				expectName = !nesting.isEmpty() && nesting.last() == '{';
+				++pos;
+				continue;
+			case ':':
+				++pos;
+				continue;
+			case '{':
+				nesting.append('{');
+				expectName = true;
+				++pos;
+				current = BeginObject;
+				return current;
+			case '[':
+				nesting.append('[');
+				expectName = false;
+				++pos;
+				current = BeginArray;
+				return current;
+			case '}':
+			case ']':
+				if (nesting.isEmpty() || nesting.last() != (c == '}' ? '{' : '['))
+				{
+					return fail();
+				}
+				nesting.removeLast();
+				expectName = false;
+				++pos;
+				current = c == '}' ? EndObject : EndArray;
+				return current;
+			case '"':
+				if (!scanString())
+				{
+					return fail();
+				}
+				current = expectName ? Name : String;
+				expectName = false;
+				return current;
+			case 't':
+			case 'f':
+			case 'n':
+			{
+				const char* literal = c == 't' ? "true" : (c == 'f' ? "false" : "null");
+				const auto	length = static_cast<qsizetype>(std::strlen(literal));
+				if (end - pos < length || std::memcmp(pos, literal, length) != 0)
+				{
+					return fail();
+				}
+				tokenBegin = pos;
+				pos += length;
+				tokenEnd = pos;
+				current = c == 'n' ? Null : Bool;
+				return current;
+			}
+			default:
+				if (c == '-' || (c >= '0' && c <= '9'))
+				{
+					tokenBegin = pos;
+					while (pos < end && (*pos == '-' || *pos == '+' || *pos == '.' || *pos == 'e' || *pos == 'E' ||
+										 (*pos >= '0' && *pos <= '9')))
+					{
+						++pos;
+					}
+					tokenEnd = pos;
+					current = Number;
+					return current;
+				}
+				return fail();
+		}
+	}
+}
+
+JsonStreamReader::Token JsonStreamReader::token() const
+{
+	return current;
+}
+
+QByteArrayView JsonStreamReader::skipCurrent()
+{
+	if (current != BeginObject && current != BeginArray)
+	{
+		return QByteArrayView(valueBegin, pos - valueBegin);
+	}
+
+	const char*		  start = valueBegin;
+	const qsizetype	  depth = nesting.size() - 1;
+
+	while (nesting.size() > depth)
+	{
+		pos = findStructural(pos, end);
+		if (pos == end)
+		{
+			fail();
+			return {};
+		}
+
+		switch (*pos)
+		{
+			case '"':
+				if (!scanString())
+				{
+					fail();
+					return {};
+				}
+				continue;
+			case '{':
+			case '[':
+				nesting.append(*pos);
+				break;
+			default:
+				if (nesting.last() != (*pos == '}' ? '{' : '['))
+				{
+					fail();
+					return {};
+				}
+				nesting.removeLast();
+				break;
+		}
+		++pos;
+	}
+
+	current = *(pos - 1) == '}' ? EndObject : EndArray;
+	expectName = false;
+	return QByteArrayView(start, pos - start);
+}
+
+QByteArrayView JsonStreamReader::rawText() const
+{
+	return QByteArrayView(tokenBegin, tokenEnd - tokenBegin);
+}
+
+bool JsonStreamReader::hasEscapes() const
+{
+	return escaped;
+}
+
+QString JsonStreamReader::text() const
+{
+	if (!escaped)
+	{
+		return QString::fromUtf8(tokenBegin, tokenEnd - tokenBegin);
+	}
+
+	QString		result;
+	const char* run = tokenBegin;
+	const char* p = tokenBegin;
+
+	result.reserve(tokenEnd - tokenBegin);
+	while (p < tokenEnd)
+	{
+		if (*p != '\\')
+		{
+			++p;
+			continue;
+		}
+
+		result.append(QString::fromUtf8(run, p - run));
+		if (p + 1 >= tokenEnd)
+		{
+			run = p;
+			break;
+		}
+
+		switch (p[1])
+		{
+			case 'b':
+				result.append(QLatin1Char('\b'));
+				break;
+			case 'f':
+				result.append(QLatin1Char('\f'));
+				break;
+			case 'n':
+				result.append(QLatin1Char('\n'));
+				break;
+			case 'r':
+				result.append(QLatin1Char('\r'));
+				break;
+			case 't':
+				result.append(QLatin1Char('\t'));
+				break;
+			case 'u':
+			{
+				// Surrogate pairs arrive as two escapes and simply end up as two UTF-16 code units
+				const int unit = tokenEnd - p >= 6 ? parseHex4(p + 2) : -1;
+				if (unit >= 0)
+				{
+					result.append(QChar(static_cast<char16_t>(unit)));
+					p += 4;
+				}
+				break;
+			}
+			default:
+				result.append(QLatin1Char(p[1]));
+				break;
+		}
+		p += 2;
+		run = p;
+	}
+	result.append(QString::fromUtf8(run, tokenEnd - run));
+	return result;
+}
+
+qint64 JsonStreamReader::integerValue() const
+{
+	return rawText().toLongLong();
+}
+
+double JsonStreamReader::doubleValue() const
+{
+	return rawText().toDouble();
+}
+
+bool JsonStreamReader::boolValue() const
+{
+	return current == Bool && *tokenBegin == 't';
+}
+
+QJsonValue JsonStreamReader::scalarValue() const
+{
+	switch (current)
+	{
+		case String:
+		case Name:
+			return text();
+		case Bool:
+			return boolValue();
+		case Null:
+			return QJsonValue::Null;
+		case Number:
+		{
+			bool		 integral = false;
+			const qint64 integer = rawText().toLongLong(&integral);
+			if (integral)
+			{
+				return integer;
+			}
+			return doubleValue();
+		}
+		default:
+			return QJsonValue::Undefined;
+	}
+}
+
+bool JsonStreamReader::hasError() const
+{
+	return current == Invalid && pos != begin;
+}
+
+void JsonStreamReader::skipWhitespace()
+{
+	while (pos < end && (*pos == ' ' || *pos == '\n' || *pos == '\r' || *pos == '\t'))
+	{
+		++pos;
+	}
+}
+
+bool JsonStreamReader::scanString()
+{
+	const char* p = pos + 1;
+
+	escaped = false;
+	for (;;)
+	{
+		p = findQuoteOrBackslash(p, end);
+		if (p == end)
+		{
+			return false;
+		}
+		if (*p == '"')
+		{
+			break;
+		}
+		escaped = true;
+		p += 2;
+	}
+
+	tokenBegin = pos + 1;
+	tokenEnd = p;
+	pos = p + 1;
+	return true;
+}
+
+JsonStreamReader::Token JsonStreamReader::fail()
+{
+	current = Invalid;
+	if (pos == begin)
+	{
+		// Keep hasError() meaningful for documents failing on their first byte
+		++pos;
+	}
+	return current;
+}
@@ -0,0 +1,157 @@
+/**
+ * @file JsonStreamReader.h
+ * @brief Header file for the JsonStreamReader class.
+ *
+ * This file contains the declaration of a forward-only JSON pull parser working directly on the
+ * received bytes, used to decode large replies without building a QJsonDocument.
+ */
+
+#ifndef JSONSTREAMREADER_H
+#define JSONSTREAMREADER_H
+
+#include <QByteArrayView>
+#include <QJsonValue>
+#include <QString>
+#include <QVarLengthArray>
+
+/**
+ * @class JsonStreamReader
+ * @brief A forward-only, allocation free JSON tokenizer.
+ *
+ * The reader walks the document once and reports one token per readNext() call. Member names are
+ * reported as @ref Name tokens followed by the token of their value. Strings and numbers are only
+ * converted on request, so skipped members cost nothing but the scan itself.
+ *
+ * Scanning for the end of strings and for the structural characters of skipped values is done
+ * 16 bytes at a time with SSE2 when the target supports it.
+ *
+ * The reader is lenient: it checks nesting but not the position of commas and colons, which is
+ * enough for trusted server replies.
+ */
+class JsonStreamReader
+{
+public:
+	/**
+	 * @enum Token
+	 * @brief Defines the tokens reported by readNext().
+	 */
+	enum Token
+	{
+		Invalid,	 ///< Malformed input, reading cannot continue.
+		BeginObject, ///< '{'
+		EndObject,	 ///< '}'
+		BeginArray,	 ///< '['
+		EndArray,	 ///< ']'
+		Name,		 ///< A member name, the next token is its value.
+		String,		 ///< A string value.
+		Number,		 ///< A number value.
+		Bool,		 ///< true or false.
+		Null,		 ///< null.
+		EndOfDocument ///< The whole document has been read.
+	};
+
+	/**
+	 * @brief Constructs a reader over a complete document.
+	 *
+	 * @param document The JSON text, which must outlive the reader.
+	 */
+	explicit JsonStreamReader(QByteArrayView document);
+
+	/**
+	 * @brief Reads the next token.
+	 *
+	 * @return The token read, also available from token().
+	 */
+	Token readNext();
+
+	/**
+	 * @brief Returns the last token read.
+	 */
+	Token token() const;
+
+	/**
+	 * @brief Skips the value whose first token was just read.
+	 *
+	 * If the current token is BeginObject or BeginArray, the reader moves past the matching end
+	 * token. Scalars are already complete and are left as they are.
+	 *
+	 * @return The raw JSON text of the value.
+	 */
+	QByteArrayView skipCurrent();
+
+	/**
+	 * @brief Returns the raw text of the current Name, String or Number token.
+	 *
+	 * Names and strings are returned without their quotes and with escape sequences left as is.
+	 */
+	QByteArrayView rawText() const;
+
+	/**
+	 * @brief Tells whether the current Name or String token contains escape sequences.
+	 */
+	bool hasEscapes() const;
+
+	/**
+	 * @brief Returns the unescaped text of the current Name or String token.
+	 */
+	QString text() const;
+
+	/**
+	 * @brief Returns the current Number token as an integer, or 0 if it is not integral.
+	 */
+	qint64 integerValue() const;
+
+	/**
+	 * @brief Returns the current Number token as a double.
+	 */
+	double doubleValue() const;
+
+	/**
+	 * @brief Returns the value of the current Bool token.
+	 */
+	bool boolValue() const;
+
+	/**
+	 * @brief Converts the current scalar token into a QJsonValue.
+	 *
+	 * Integral numbers are kept as integers. Containers are not scalars and give an undefined value,
+	 * use skipCurrent() and QJsonDocument on the returned text for them.
+	 */
+	QJsonValue scalarValue() const;
+
+	/**
+	 * @brief Tells whether the reader stopped on malformed input.
+	 */
+	bool hasError() const;
+
+private:
+	/**
+	 * @brief Moves past whitespace.
+	 */
+	void skipWhitespace();
+
+	/**
+	 * @brief Scans a string whose opening quote is at the current position.
+	 *
+	 * @return false if the string is not terminated.
+	 */
+	bool scanString();
+
+	/**
+	 * @brief Reports a malformed document.
+	 */
+	Token fail();
+
+	const char* begin;				///< First byte of the document.
+	const char* end;				///< One past the last byte of the document.
+	const char* pos;				///< Current read position.
+	const char* tokenBegin;			///< First byte of the current token text.
+	const char* tokenEnd;			///< One past the last byte of the current token text.
+	const char* valueBegin;			///< First byte of the current token, quotes and brackets included.
+	Token		current;			///< Last token read.
+	bool		escaped;			///< Whether the current string contains escape sequences.
+	bool		expectName;			///< Whether the next string is a member name.
+	QVarLengthArray<char, 16> nesting; ///< Open containers, '{' or '['.
+};
+
+#endif // JSONSTREAMREADER_H
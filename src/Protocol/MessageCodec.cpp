@@ -0,0 +1,175 @@
+/**
+ * @file MessageCodec.cpp
+ * @brief Implementation file for the message codecs.
+ */
+#include "MessageCodec.h"
+#include "JsonStreamReader.h"
+
+#include <QJsonDocument>
+#include <QJsonParseError>
+#include <QCborValue>
+#include <QCborMap>
+#include <QCborStreamReader>
+
+const MessageCodec& MessageCodec::forFormat(Format format)
+{
+	static const JsonCodec jsonCodec;
+	static const CborCodec cborCodec;
+
+	if (format == Cbor)
+	{
+		return cborCodec;
+	}
+	return jsonCodec;
+}
+
+const MessageCodec* MessageCodec::forName(const QString& name)
+{
+	if (name == QLatin1String("cbor"))
+	{
+		return &forFormat(Cbor);
+	}
+	if (name == QLatin1String("json"))
+	{
+		return &forFormat(Json);
+	}
+	return nullptr;
+}
+
+QStringList MessageCodec::supportedNames()
+{
+	return {"cbor", "json"};
+}
+
+MessageCodec::Format JsonCodec::format() const
+{
+	return Json;
+}
+
+QString JsonCodec::name() const
+{
+	return "json";
+}
+
+QByteArray JsonCodec::encode(const QJsonObject& message) const
+{
+	return QJsonDocument(message).toJson(QJsonDocument::Compact);
+}
+
+QJsonObject JsonCodec::decode(const QByteArray& payload, bool* ok) const
+{
+	QJsonParseError error;
+	QJsonDocument	document = QJsonDocument::fromJson(payload, &error);
+
+	if (ok != nullptr)
+	{
+		*ok = error.error == QJsonParseError::NoError && document.isObject();
+	}
+	return document.object();
+}
+
+bool JsonCodec::peek(const QByteArray& payload, Envelope& envelope) const
+{
+	JsonStreamReader reader(payload);
+
+	if (reader.readNext() != JsonStreamReader::BeginObject)
+	{
+		return false;
+	}
+
+	while (reader.readNext() == JsonStreamReader::Name)
+	{
+		const QByteArrayView name = reader.rawText();
+		reader.readNext();
+
+		if ((name == "Response" || name == "Request") && reader.token() == JsonStreamReader::Number)
+		{
+			envelope.code = static_cast<int>(reader.integerValue());
+		}
+		else if (name == "RequestId" && reader.token() == JsonStreamReader::Number)
+		{
+			envelope.requestId = reader.integerValue();
+			envelope.hasRequestId = true;
+		}
+		else
+		{
+			reader.skipCurrent();
+		}
+	}
+
+	return reader.token() == JsonStreamReader::EndObject;
+}
+
+MessageCodec::Format CborCodec::format() const
+{
+	return Cbor;
+}
+
+QString CborCodec::name() const
+{
+	return "cbor";
+}
+
+QByteArray CborCodec::encode(const QJsonObject& message) const
+{
+	return QCborValue(QCborMap::fromJsonObject(message)).toCbor();
+}
+
+QJsonObject CborCodec::decode(const QByteArray& payload, bool* ok) const
+{
+	QCborStreamReader reader(payload);
+	QCborValue		  value = QCborValue::fromCbor(reader);
+
+	if (ok != nullptr)
+	{
+		*ok = reader.lastError() == QCborError::NoError && value.isMap();
+	}
+	return value.toMap().toJsonObject();
+}
+
+bool CborCodec::peek(const QByteArray& payload, Envelope& envelope) const
+{
+	QCborStreamReader reader(payload);
+
+	if (!reader.isMap() || !reader.enterContainer())
+	{
+		return false;
+	}
+
+	while (reader.lastError() == QCborError::NoError && reader.hasNext())
+	{
+		QString key;
+
+		if (reader.isString())
+		{
+			auto chunk = reader.readString();
+			while (chunk.status == QCborStreamReader::Ok)
+			{
+				key += chunk.data;
+				chunk = reader.readString();
+			}
+		}
+		else
+		{
+			reader.next();
+		}
+
+		if ((key == QLatin1String("Response") || key == QLatin1String("Request")) && reader.isInteger())
+		{
+			envelope.code = static_cast<int>(reader.toInteger());
+			reader.next();
+		}
+		else if (key == QLatin1String("RequestId") && reader.isInteger())
+		{
+			envelope.requestId = reader.toInteger();
+			envelope.hasRequestId = true;
+			reader.next();
+		}
+		else
+		{
+			reader.next();
+		}
+	}
+
+	return reader.lastError() == QCborError::NoError && reader.leaveContainer();
+}
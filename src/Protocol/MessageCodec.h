@@ -0,0 +1,145 @@
+/**
+ * @file MessageCodec.h
+ * @brief Header file for the MessageCodec class and its implementations.
+ *
+ * This file contains the declaration of the codecs used to turn request and response envelopes
+ * into bytes on the wire. JSON text is always available, CBOR is used when the server accepts it
+ * during the handshake that follows every connection.
+ */
+
+#ifndef MESSAGECODEC_H
+#define MESSAGECODEC_H
+
+#include <QByteArray>
+#include <QJsonObject>
+#include <QMetaType>
+#include <QString>
+#include <QStringList>
+
+/**
+ * @class MessageCodec
+ * @brief Interface of a wire encoding for envelopes.
+ *
+ * Codecs are stateless, the instances returned by forFormat() and forName() can be shared freely
+ * between threads.
+ */
+class MessageCodec
+{
+public:
+	/**
+	 * @enum Format
+	 * @brief Defines the available wire encodings.
+	 */
+	enum Format
+	{
+		Json, ///< Compact JSON text, the fallback every server understands.
+		Cbor  ///< Binary CBOR (RFC 8949).
+	};
+
+	/**
+	 * @struct Envelope
+	 * @brief The routing fields of an envelope, read without decoding its "Data".
+	 */
+	struct Envelope
+	{
+		int	   code = 0;			   ///< The "Request" or "Response" code, 0 if absent.
+		qint64 requestId = -1;		   ///< The "RequestId", if present.
+		bool   hasRequestId = false; ///< Whether the envelope carries a "RequestId".
+	};
+
+	virtual ~MessageCodec() = default;
+
+	/**
+	 * @brief Returns the format implemented by this codec.
+	 */
+	virtual Format format() const = 0;
+
+	/**
+	 * @brief Returns the name used for this codec during the handshake.
+	 */
+	virtual QString name() const = 0;
+
+	/**
+	 * @brief Serializes an envelope.
+	 *
+	 * @param message The envelope to serialize.
+	 * @return The encoded bytes.
+	 */
+	virtual QByteArray encode(const QJsonObject& message) const = 0;
+
+	/**
+	 * @brief Deserializes an envelope.
+	 *
+	 * @param payload The encoded bytes.
+	 * @param ok Set to false if the payload is not a valid envelope, may be nullptr.
+	 * @return The decoded envelope, empty on error.
+	 */
+	virtual QJsonObject decode(const QByteArray& payload, bool* ok = nullptr) const = 0;
+
+	/**
+	 * @brief Reads the routing fields of an envelope.
+	 *
+	 * The "Data" member is skipped without being decoded, so this is much cheaper than decode() on
+	 * large replies.
+	 *
+	 * @param payload The encoded bytes.
+	 * @param envelope Receives the fields found.
+	 * @return false if the payload is not a valid envelope.
+	 */
+	virtual bool peek(const QByteArray& payload, Envelope& envelope) const = 0;
+
+	/**
+	 * @brief Returns the shared codec for a format.
+	 *
+	 * @param format The wanted format.
+	 * @return The codec instance.
+	 */
+	static const MessageCodec& forFormat(Format format);
+
+	/**
+	 * @brief Returns the shared codec negotiated under a given name.
+	 *
+	 * @param name The handshake name, e.g. "cbor".
+	 * @return The codec instance, or nullptr if the name is unknown.
+	 */
+	static const MessageCodec* forName(const QString& name);
+
+	/**
+	 * @brief Returns the names offered to the server, in order of preference.
+	 */
+	static QStringList supportedNames();
+};
+
+Q_DECLARE_METATYPE(MessageCodec::Format)
+
+/**
+ * @class JsonCodec
+ * @brief Encodes envelopes as compact JSON text.
+ *
+ * Envelopes are peeked with @ref JsonStreamReader.
+ */
+class JsonCodec : public MessageCodec
+{
+public:
+	Format		format() const override;
+	QString		name() const override;
+	QByteArray	encode(const QJsonObject& message) const override;
+	QJsonObject decode(const QByteArray& payload, bool* ok = nullptr) const override;
+	bool		peek(const QByteArray& payload, Envelope& envelope) const override;
+};
+
+/**
+ * @class CborCodec
+ * @brief Encodes envelopes as CBOR, using QCborValue and QCborStreamReader.
+ */
+class CborCodec : public MessageCodec
+{
+public:
+	Format		format() const override;
+	QString		name() const override;
+	QByteArray	encode(const QJsonObject& message) const override;
+	QJsonObject decode(const QByteArray& payload, bool* ok = nullptr) const override;
+	bool		peek(const QByteArray& payload, Envelope& envelope) const override;
+};
+
+#endif // MESSAGECODEC_H
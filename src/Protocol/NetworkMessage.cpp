@@ -0,0 +1,42 @@
+/**
+ * @file NetworkMessage.cpp
+ * @brief Implementation file for the NetworkMessage class.
+ */
+#include "NetworkMessage.h"
+
+#include <utility>
+
+NetworkMessage::NetworkMessage(QJsonObject envelope, QByteArray payload, MessageCodec::Format format) :
+	envelope_(std::move(envelope)), payload_(std::move(payload)), format_(format)
+{
+}
+
+MessagePtr NetworkMessage::fromEnvelope(QJsonObject envelope)
+{
+	return MessagePtr(new NetworkMessage(std::move(envelope), QByteArray(), MessageCodec::Json));
+}
+
+MessagePtr NetworkMessage::fromPayload(QByteArray payload, MessageCodec::Format format)
+{
+	return MessagePtr(new NetworkMessage(QJsonObject(), std::move(payload), format));
+}
+
+const QJsonObject& NetworkMessage::envelope() const
+{
+	return envelope_;
+}
+
+const QByteArray& NetworkMessage::payload() const
+{
+	return payload_;
+}
+
+MessageCodec::Format NetworkMessage::format() const
+{
+	return format_;
+}
+
+bool NetworkMessage::isEncoded() const
+{
+	return !payload_.isNull();
+}
@@ -0,0 +1,87 @@
+/**
+ * @file NetworkMessage.h
+ * @brief Header file for the NetworkMessage class.
+ *
+ * This file contains the declaration of the immutable message handed between the GUI, network and
+ * decode threads.
+ */
+
+#ifndef NETWORKMESSAGE_H
+#define NETWORKMESSAGE_H
+
+#include <QByteArray>
+#include <QJsonObject>
+#include <QMetaType>
+#include <QSharedPointer>
+#include "MessageCodec.h"
+
+class NetworkMessage;
+
+/**
+ * @brief Shared handle to an immutable message, the only way messages cross thread boundaries.
+ */
+using MessagePtr = QSharedPointer<const NetworkMessage>;
+
+/**
+ * @class NetworkMessage
+ * @brief An immutable, reference-counted message of the request/response pipeline.
+ *
+ * A message is built once, where it originates, and is never modified afterwards. Passing a
+ * @ref MessagePtr through a queued connection only copies the pointer, so the envelope or payload
+ * it carries is shared by every stage instead of being copied.
+ *
+ * Requests carry the envelope built by the RequestManager, which is encoded once by the ClientHandler.
+ * Replies carry the payload received by the TcpClient, which is decoded once by the decode thread.
+ * Events synthesized by the client itself, such as connection changes, carry an envelope only.
+ */
+class NetworkMessage
+{
+public:
+	/**
+	 * @brief Creates a message carrying an envelope.
+	 *
+	 * @param envelope The envelope.
+	 * @return The shared message.
+	 */
+	static MessagePtr fromEnvelope(QJsonObject envelope);
+
+	/**
+	 * @brief Creates a message carrying an encoded payload.
+	 *
+	 * @param payload The encoded envelope, moved into the message.
+	 * @param format The encoding of the payload.
+	 * @return The shared message.
+	 */
+	static MessagePtr fromPayload(QByteArray payload, MessageCodec::Format format);
+
+	/**
+	 * @brief Returns the envelope, empty for messages created with fromPayload().
+	 */
+	const QJsonObject& envelope() const;
+
+	/**
+	 * @brief Returns the encoded payload, null for messages created with fromEnvelope().
+	 */
+	const QByteArray& payload() const;
+
+	/**
+	 * @brief Returns the encoding of the payload.
+	 */
+	MessageCodec::Format format() const;
+
+	/**
+	 * @brief Tells whether the message carries an encoded payload rather than an envelope.
+	 */
+	bool isEncoded() const;
+
+private:
+	NetworkMessage(QJsonObject envelope, QByteArray payload, MessageCodec::Format format);
+
+	const QJsonObject		   envelope_; ///< The envelope of requests and local events.
+	const QByteArray		   payload_;  ///< The encoded bytes of replies.
+	const MessageCodec::Format format_;	  ///< The encoding of payload_.
+};
+
+Q_DECLARE_METATYPE(MessagePtr)
+
+#endif // NETWORKMESSAGE_H
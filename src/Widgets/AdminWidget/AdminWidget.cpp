@@ -3,8 +3,10 @@
 #include <QApplication>
 #include <QGuiApplication>
 #include <QScreen>
+#include <QScrollBar>
 #include <QMessageBox>
 #include <QVariantMap>
+#include <algorithm>
 
 #include "UpdateUserDialog.h"
 #include "CreateUserDialog.h"
@@ -14,8 +16,10 @@
 
 AdminWidget::AdminWidget(QString email, QString first_name, QWidget* parent) :
 	QWidget(parent), admin_email_{email}, admin_first_name_{first_name}, notificationSnackbar{nullptr}, tabs{nullptr},
-	tabContents{nullptr}, databaseTable{nullptr}, transactionsTable{nullptr}, updateUserFab{nullptr},
-	deleteUserFab{nullptr}, createNewUserFab{nullptr}, selectedUserData{}, welcomeLabel{nullptr}, logoutDialog{nullptr},
+	tabContents{nullptr}, databaseModel{nullptr}, pagedDatabaseModel{nullptr}, searchResultsModel{nullptr}, browseModel{nullptr}, searchTimer{nullptr},
+	pendingSearchRequest{-1}, serverSearchThreshold{DefaultServerSearchThreshold}, changeTimer{nullptr},
+	pendingSubscribeRequest{-1}, subscribed{false}, transactionsModel{nullptr}, searchField{nullptr}, databaseTable{nullptr}, transactionsTable{nullptr}, updateUserFab{nullptr},
+	deleteUserFab{nullptr}, createNewUserFab{nullptr}, selectedUser{}, hasSelectedUser{false}, welcomeLabel{nullptr}, logoutDialog{nullptr},
 	requestManager{RequestManager::getInstance()}
 {
 	// set object name
@@ -63,6 +67,17 @@ AdminWidget::AdminWidget(QString email, QString first_name, QWidget* parent) :
 
 	// Floating Action Buttons
 	setupFloatingActionButtons();
+
+	// Pushed changes are applied once per frame, however many arrive
+	changeTimer = new QTimer(this);
+	changeTimer->setSingleShot(true);
+	changeTimer->setInterval(ChangeCoalescingInterval);
+	connect(changeTimer, &QTimer::timeout, this, &AdminWidget::applyPendingChanges);
+
+	subscribe();
+
+	// The first page of users is requested right away, so the table is filled on first paint
+	pagedDatabaseModel->refresh();
 }
 
 QWidget* AdminWidget::createDatabaseTab()
@@ -74,10 +89,27 @@ QWidget* AdminWidget::createDatabaseTab()
 	welcomeLabel = new QtMaterialFlatButton("Welcome, " + admin_first_name_, Material::ButtonTextPrimary, databaseTab);
 	layout->addWidget(welcomeLabel);
 
-	databaseTable = new QTableWidget(databaseTab);
+	searchField = new QtMaterialTextField(databaseTab);
+	searchField->setPlaceholderText("Search by account number, email or name (role:, balance:, account: for ranges)");
+	searchField->setEchoMode(QLineEdit::Normal);
+	layout->addWidget(searchField);
+
+	connect(searchField, &QtMaterialTextField::textChanged, this, &AdminWidget::onSearchTextChanged);
+	connect(searchField, &QtMaterialTextField::returnPressed, this, &AdminWidget::onSearchNext);
+
+	// Server searches are sent once typing pauses, not for every key
+	searchTimer = new QTimer(this);
+	searchTimer->setSingleShot(true);
+	searchTimer->setInterval(250);
+	connect(searchTimer, &QTimer::timeout, this, &AdminWidget::sendSearch);
+
+	databaseModel = new UserTableModel(this);
+	// Servers paging GetDatabase are shown through this model instead, see onDatabaseContentUpdated
+	pagedDatabaseModel = new PagedUserTableModel(QVariantMap(), this);
+	searchResultsModel = new UserTableModel(this);
+
+	databaseTable = new QTableView(databaseTab);
 	// These settings only need to be set once
-	databaseTable->setColumnCount(6);
-	databaseTable->setHorizontalHeaderLabels({"Account Number", "First Name", "Last Name", "Email", "Role", "Balance"});
 	databaseTable->setGridStyle(Qt::NoPen);
 	databaseTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
 	databaseTable->setSelectionBehavior(QAbstractItemView::SelectRows);
@@ -86,10 +118,23 @@ QWidget* AdminWidget::createDatabaseTab()
 	databaseTable->verticalHeader()->setVisible(false);
 	databaseTable->horizontalHeader()->setStretchLastSection(true);
 
+	// Uniform row heights let the view map the scroll position to rows without measuring them,
+	// so only the visible rows are ever materialized
+	databaseTable->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+	databaseTable->verticalHeader()->setDefaultSectionSize(databaseTable->fontMetrics().height() + 8);
+
+	// Size columns from a sample of rows instead of all of them
+	databaseTable->horizontalHeader()->setResizeContentsPrecision(100);
+
+	// Pages of the paged database are requested for the rows scrolled to, the model never asks by itself
+	connect(databaseTable->verticalScrollBar(), &QScrollBar::valueChanged, this, &AdminWidget::loadVisibleUsers);
+	connect(databaseTable->verticalScrollBar(), &QScrollBar::rangeChanged, this, &AdminWidget::loadVisibleUsers);
+
 	layout->addWidget(databaseTable);
 
-	connect(databaseTable->selectionModel(), &QItemSelectionModel::selectionChanged, this,
-			&AdminWidget::onUserSelectionChanged);
+	showBrowseModel(databaseModel);
+	setupSorting(databaseTable, databaseModel);
+	setupSorting(databaseTable, searchResultsModel);
 
 	return databaseTab;
 }
@@ -100,9 +145,11 @@ QWidget* AdminWidget::createTransactionsTab()
 	QVBoxLayout* layout = createTabLayout();
 	transactionsTab->setLayout(layout);
 
-	transactionsTable = new QTableWidget(transactionsTab);
-	transactionsTable->setColumnCount(4);
-	transactionsTable->setHorizontalHeaderLabels({"From Account", "To Account", "Amount", "Date of Transaction"});
+	transactionsModel = new TransactionTableModel(QVariantMap(), this);
+	connect(transactionsModel, &TransactionTableModel::refreshed, this, &AdminWidget::onTransactionsRefreshed);
+
+	transactionsTable = new QTableView(transactionsTab);
+	transactionsTable->setModel(transactionsModel);
 	transactionsTable->setGridStyle(Qt::NoPen);
 	transactionsTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
 	transactionsTable->setSelectionBehavior(QAbstractItemView::SelectRows);
@@ -110,6 +157,18 @@ QWidget* AdminWidget::createTransactionsTab()
 	transactionsTable->setAlternatingRowColors(true);
 	transactionsTable->verticalHeader()->setVisible(false);
 	transactionsTable->horizontalHeader()->setStretchLastSection(true);
+	transactionsTable->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+	transactionsTable->verticalHeader()->setDefaultSectionSize(transactionsTable->fontMetrics().height() + 8);
+
+	transactionsTable->horizontalHeader()->setResizeContentsPrecision(100);
+	for (int column = 0; column < TransactionTableModel::ColumnCount; ++column)
+	{
+		transactionsTable->horizontalHeader()->setSectionResizeMode(column, QHeaderView::ResizeToContents);
+	}
+	transactionsTable->horizontalHeader()->setSectionResizeMode(TransactionTableModel::ColumnCount - 1,
+																QHeaderView::Stretch);
+
+	setupSorting(transactionsTable, transactionsModel);
 
 	layout->addWidget(transactionsTable);
 
@@ -273,83 +332,56 @@ void AdminWidget::onLogoutConfirmed()
 	emit logout();
 }
 
-void AdminWidget::onDatabaseContentUpdated(const QList<QMap<QString, QString>>& data)
+void AdminWidget::onDatabaseContentUpdated(const UserPage& page)
 {
-	databaseContent_ = data;
-
-	databaseTable->setRowCount(0); // Clear existing rows
-	databaseTable->selectedItems().isEmpty();
-
-	for (const auto& user: databaseContent_)
+	if (pagedDatabaseModel->applyPage(page))
 	{
-		int row = databaseTable->rowCount();
-		databaseTable->insertRow(row);
+		showBrowseModel(pagedDatabaseModel);
+		onUserSelectionChanged();
 
-		QTableWidgetItem* accountNumberItem = new QTableWidgetItem(user.value("account_number"));
-		QTableWidgetItem* firstNameItem = new QTableWidgetItem(user.value("first_name"));
-		QTableWidgetItem* lastNameItem = new QTableWidgetItem(user.value("last_name"));
-		QTableWidgetItem* emailItem = new QTableWidgetItem(user.value("email"));
-		QTableWidgetItem* roleItem = new QTableWidgetItem(user.value("role"));
-		QTableWidgetItem* balanceItem = new QTableWidgetItem(user.value("balance"));
-
-		databaseTable->setItem(row, 0, accountNumberItem);
-		databaseTable->setItem(row, 1, firstNameItem);
-		databaseTable->setItem(row, 2, lastNameItem);
-		databaseTable->setItem(row, 3, emailItem);
-		databaseTable->setItem(row, 4, roleItem);
-		databaseTable->setItem(row, 5, balanceItem);
+		if (page.offset == 0)
+		{
+			onSuccessfullRequest("Database updated Successfully");
+		}
+		return;
 	}
 
-	// Ensure columns resize to fit content but don't leave excess space
-	for (int column = 0; column < databaseTable->columnCount(); ++column)
+	// A late page of a paged reply, the whole database otherwise
+	if (page.total >= 0)
 	{
-		databaseTable->horizontalHeader()->setSectionResizeMode(column, QHeaderView::ResizeToContents);
+		return;
 	}
-	// Set the last column to stretch to fill any remaining space
-	databaseTable->horizontalHeader()->setSectionResizeMode(databaseTable->columnCount() - 1, QHeaderView::Stretch);
 
-	// Optionally, you can force a resize to contents for better accuracy
-	// databaseTable->resizeColumnsToContents(); // This might not be necessary if resize mode is set correctly
+	const UserTableModel::RowEdit edit = databaseModel->setUsers(page.users);
+	searchIndex.applyEdit(databaseModel->users(), edit);
+	showBrowseModel(databaseModel);
+
+	// The selected user may have been edited, and a model reset clears the selection without notifying
+	onUserSelectionChanged();
 
 	onSuccessfullRequest("Database updated Successfully");
 }
 
-void AdminWidget::onTransactionsFetched(const QList<QMap<QString, QString>>& transactions)
+void AdminWidget::onTransactionsFetched(const TransactionPage& page)
 {
-	transactions_ = transactions;
-
-	transactionsTable->setRowCount(0); // Clear existing rows
-	transactionsTable->selectedItems().isEmpty();
+	transactionsModel->applyPage(page);
+}
 
-	for (const auto& transaction: transactions_)
+void AdminWidget::onResultUnchanged(qint64 requestId)
+{
+	// The content shown is still current, nothing is decoded nor redrawn
+	if (!pagedDatabaseModel->applyNotModified(requestId))
 	{
-		int row = transactionsTable->rowCount();
-		transactionsTable->insertRow(row);
-
-		QTableWidgetItem* fromAccountItem = new QTableWidgetItem(transaction["from_account_number"]);
-		QTableWidgetItem* toAccountItem = new QTableWidgetItem(transaction["to_account_number"]);
-		QTableWidgetItem* amountItem = new QTableWidgetItem(transaction["transaction_amount"]);
-		QTableWidgetItem* dateItem = new QTableWidgetItem(transaction["created_at"]);
-
-		transactionsTable->setItem(row, 0, fromAccountItem);
-		transactionsTable->setItem(row, 1, toAccountItem);
-		transactionsTable->setItem(row, 2, amountItem);
-		transactionsTable->setItem(row, 3, dateItem);
+		transactionsModel->applyNotModified(requestId);
 	}
+}
 
-	// Ensure columns resize to fit content but don't leave excess space
-	for (int column = 0; column < transactionsTable->columnCount(); ++column)
+void AdminWidget::onTransactionsRefreshed(int newRows)
+{
+	if (newRows > 0)
 	{
-		transactionsTable->horizontalHeader()->setSectionResizeMode(column, QHeaderView::ResizeToContents);
+		onSuccessfullRequest("Transactions updated Successfully");
 	}
-	// Set the last column to stretch to fill any remaining space
-	transactionsTable->horizontalHeader()->setSectionResizeMode(transactionsTable->columnCount() - 1,
-																QHeaderView::Stretch);
-
-	// Optionally, you can force a resize to contents for better accuracy
-	// transactionsTable->resizeColumnsToContents(); // This might not be necessary if resize mode is set correctly
-
-	onSuccessfullRequest("Transactions updated Successfully");
 }
 
 void AdminWidget::onSuccessfullRequest(QString message)
@@ -362,6 +394,9 @@ void AdminWidget::onSuccessfullRequest(QString message)
 	if (message == "Email updated successfully")
 	{
 		admin_email_ = admin_new_email_;
+
+		// Requests sent without a session token identify the admin by email
+		requestManager->openSession(admin_email_);
 	}
 }
 
@@ -376,10 +411,14 @@ void AdminWidget::updateDatabaseTable()
 {
 	if (tabs->currentIndex() == 0)
 	{
-		QVariantMap data;
-		data.insert("email", admin_email_);
-
-		requestManager->createRequest(RequestManager::GetDatabase, data);
+		// Servers that do not page the database ignore the paging fields and send every user. Once
+		// subscribed, the changes are pushed and the rows loaded stay current. Until the first rows
+		// arrive, the page requested at login is awaited rather than requested again.
+		const bool loaded = pagedDatabaseModel->rowCount() > 0 || databaseModel->rowCount() > 0;
+		if (loaded ? !subscribed : !pagedDatabaseModel->isFetching())
+		{
+			pagedDatabaseModel->refresh();
+		}
 
 		createNewUserFab->show();
 		updateUserFab->show();
@@ -397,10 +436,7 @@ void AdminWidget::updateTransactionsTable()
 {
 	if (tabs->currentIndex() == 1)
 	{
-		QVariantMap data;
-		data.insert("email", admin_email_);
-
-		requestManager->createRequest(RequestManager::GetTransactionsHistory, data);
+		transactionsModel->refresh();
 	}
 }
 
@@ -435,27 +471,26 @@ void AdminWidget::setupFloatingActionButtons()
 
 void AdminWidget::onUpdateUserClicked()
 {
-	if (selectedUserData.isEmpty())
+	if (!hasSelectedUser)
 	{
 		return;
 	}
 
-	if (selectedUserData.value("role") == "admin")
+	if (selectedUser.role == UserRecord::Admin)
 	{
 		onFailedRequest("Cannot update admin user");
 		return;
 	}
 
-	UpdateUserDialog* dialog = new UpdateUserDialog(selectedUserData, this);
+	UpdateUserDialog* dialog = new UpdateUserDialog(selectedUser.toVariantMap(), this);
 
 	if (dialog->exec() == QDialog::Accepted)
 	{
 		QVariantMap newData = dialog->getData();
 
 		QVariantMap data;
-		data.insert("email", admin_email_);
 
-		if (selectedUserData.value("role") == "admin")
+		if (selectedUser.role == UserRecord::Admin)
 		{
 			newData.remove("role");
 
@@ -465,7 +500,7 @@ void AdminWidget::onUpdateUserClicked()
 
 			requestManager->createRequest(RequestManager::UpdateUser, data);
 		}
-		else if (selectedUserData.value("role") == "user")
+		else if (selectedUser.role == UserRecord::User)
 		{
 			data.insert("account_number", newData.value("account_number").toInt());
 			data.insert("newData", newData);
@@ -484,8 +519,6 @@ void AdminWidget::onCreateNewUserClicked()
 		QVariantMap data;
 		QVariantMap newUser = dialog->getData();
 
-		data.insert("email", admin_email_);
-
 		data.insert("newUser", newUser);
 
 		// print for debugging userdata
@@ -500,12 +533,12 @@ void AdminWidget::onCreateNewUserClicked()
 
 void AdminWidget::onDeleteUserClicked()
 {
-	if (selectedUserData.isEmpty())
+	if (!hasSelectedUser)
 	{
 		return;
 	}
 
-	if (selectedUserData.value("role") == "admin")
+	if (selectedUser.role == UserRecord::Admin)
 	{
 		onFailedRequest("Cannot delete admin user");
 		return;
@@ -514,14 +547,13 @@ void AdminWidget::onDeleteUserClicked()
 	QMessageBox::StandardButton reply;
 	reply = QMessageBox::question(this, "Delete User",
 								  "Are you sure you want to delete this user and the associated account\n" +
-									  QString::number(selectedUserData.value("account_number").toInt()) + "?",
+									  QString::number(selectedUser.accountNumber) + "?",
 								  QMessageBox::Yes | QMessageBox::No);
 
 	if (reply == QMessageBox::Yes)
 	{
 		QVariantMap data;
-		data.insert("email", admin_email_);
-		data.insert("account_number", selectedUserData.value("account_number"));
+		data.insert("account_number", selectedUser.accountNumber);
 
 		requestManager->createRequest(RequestManager::DeleteUser, data);
 	}
@@ -530,28 +562,337 @@ void AdminWidget::onDeleteUserClicked()
 void AdminWidget::onUserSelectionChanged()
 {
 	QModelIndexList selectedIndexes = databaseTable->selectionModel()->selectedRows();
-	if (selectedIndexes.size() == 1)
+	const UserRecord* user = selectedIndexes.size() == 1 ? userAtRow(selectedIndexes.first().row()) : nullptr;
+	if (user != nullptr)
 	{
-		selectedUserData.clear();
-		int selectedRow = selectedIndexes.first().row();
-		for (int i = 0; i < databaseTable->columnCount(); i++)
-		{
-			// using the same keys as the database table QTableWidget
-			selectedUserData.insert("account_number", databaseTable->item(selectedRow, 0)->text().toInt());
-			selectedUserData.insert("first_name", databaseTable->item(selectedRow, 1)->text());
-			selectedUserData.insert("last_name", databaseTable->item(selectedRow, 2)->text());
-			selectedUserData.insert("email", databaseTable->item(selectedRow, 3)->text());
-			selectedUserData.insert("role", databaseTable->item(selectedRow, 4)->text());
-			selectedUserData.insert("balance", databaseTable->item(selectedRow, 5)->text().toDouble());
-		}
+		selectedUser = *user;
+		hasSelectedUser = true;
 
 		updateUserFab->setDisabled(false);
 		deleteUserFab->setDisabled(false);
 	}
 	else
 	{
-		selectedUserData.clear();
+		hasSelectedUser = false;
 		updateUserFab->setDisabled(true);
 		deleteUserFab->setDisabled(true);
 	}
 }
+
+void AdminWidget::setServerSearchThreshold(int rows)
+{
+	serverSearchThreshold = rows;
+}
+
+void AdminWidget::onSearchTextChanged(const QString& text)
+{
+	if (usesServerSearch())
+	{
+		if (UserSearchQuery::parse(text).isEmpty())
+		{
+			// Back to the whole database, a reply still in flight is ignored
+			searchTimer->stop();
+			pendingSearchRequest = -1;
+			showDatabaseModel(browseModel);
+			onUserSelectionChanged();
+			return;
+		}
+		searchTimer->start();
+		return;
+	}
+
+	const QList<int> rows = findLocalUsers(text, 1);
+	if (!rows.isEmpty())
+	{
+		selectUserRow(databaseModel->viewRow(rows.first()));
+	}
+}
+
+void AdminWidget::onSearchNext()
+{
+	if (searchTimer->isActive())
+	{
+		searchTimer->stop();
+		sendSearch();
+		return;
+	}
+
+	const QModelIndexList selected = databaseTable->selectionModel()->selectedRows();
+	const int				current = selected.isEmpty() ? -1 : selected.first().row();
+	QList<int>				rows;
+
+	if (databaseTable->model() == searchResultsModel)
+	{
+		// Every row shown matches
+		for (int row = 0; row < searchResultsModel->rowCount(); ++row)
+		{
+			rows.append(row);
+		}
+	}
+	else if (!usesServerSearch())
+	{
+		// Matches are walked in the order they are shown
+		for (int row : findLocalUsers(searchField->text(), static_cast<int>(searchIndex.size())))
+		{
+			rows.append(databaseModel->viewRow(row));
+		}
+		std::sort(rows.begin(), rows.end());
+	}
+
+	if (rows.isEmpty())
+	{
+		return;
+	}
+
+	// Wrap around to the first match after the last one
+	const auto next = std::upper_bound(rows.cbegin(), rows.cend(), current);
+	selectUserRow(next != rows.cend() ? *next : rows.first());
+}
+
+void AdminWidget::sendSearch()
+{
+	const UserSearchQuery query = UserSearchQuery::parse(searchField->text());
+	if (query.isEmpty())
+	{
+		return;
+	}
+
+	QVariantMap data = query.toVariantMap();
+	data.insert("limit", SearchResultLimit);
+
+	requestManager->createRequest(RequestManager::SearchUsers, data);
+	pendingSearchRequest = requestManager->lastRequestId();
+}
+
+void AdminWidget::onUsersFound(const UserPage& page)
+{
+	// Only the reply to the last search typed is shown
+	if (page.requestId == -1 || page.requestId != pendingSearchRequest)
+	{
+		return;
+	}
+	pendingSearchRequest = -1;
+
+	searchResultsModel->setUsers(page.users);
+	showDatabaseModel(searchResultsModel);
+	onUserSelectionChanged();
+
+	if (page.users.isEmpty())
+	{
+		onFailedRequest("No user found");
+	}
+	else if (page.total > page.users.size())
+	{
+		onSuccessfullRequest(QString("Showing %1 of %2 users found").arg(page.users.size()).arg(page.total));
+	}
+	else
+	{
+		selectUserRow(0);
+	}
+}
+
+void AdminWidget::subscribe()
+{
+	QVariantMap data;
+	data.insert("topics", QStringList({"users"}));
+
+	requestManager->createRequest(RequestManager::Subscribe, data);
+	pendingSubscribeRequest = requestManager->lastRequestId();
+}
+
+void AdminWidget::onSubscriptionChanged(qint64 requestId, bool active)
+{
+	if (requestId == -1 || requestId != pendingSubscribeRequest)
+	{
+		return;
+	}
+
+	// Without a subscription the Database tab keeps asking for the rows again
+	pendingSubscribeRequest = -1;
+	subscribed = active;
+}
+
+void AdminWidget::onConnectionChanged(bool connected)
+{
+	if (connected)
+	{
+		subscribe();
+		return;
+	}
+
+	// Changes may have been missed while disconnected, the next refresh catches up
+	subscribed = false;
+	pendingSubscribeRequest = -1;
+}
+
+void AdminWidget::onUsersChanged(const UserChange& change)
+{
+	pendingChanges.append(change);
+	if (!changeTimer->isActive())
+	{
+		changeTimer->start();
+	}
+}
+
+void AdminWidget::applyPendingChanges()
+{
+	QList<UserChange> changes;
+	changes.swap(pendingChanges);
+
+	if (browseModel == pagedDatabaseModel)
+	{
+		pagedDatabaseModel->applyChanges(changes);
+	}
+	else if (!databaseModel->users().isEmpty())
+	{
+		// Before the first snapshot, the changes are part of it
+		const UserTableModel::RowEdit edit = databaseModel->applyChanges(changes);
+		searchIndex.applyEdit(databaseModel->users(), edit);
+	}
+
+	// Search results only show the users matching the query, so users created are not added
+	if (!searchResultsModel->users().isEmpty())
+	{
+		searchResultsModel->applyChanges(changes, false);
+	}
+
+	// The selected user may have been edited or deleted
+	onUserSelectionChanged();
+}
+
+bool AdminWidget::usesServerSearch() const
+{
+	// The search index only holds a whole snapshot
+	return browseModel == pagedDatabaseModel || searchIndex.size() > serverSearchThreshold;
+}
+
+QList<int> AdminWidget::findLocalUsers(const QString& text, int limit) const
+{
+	const QString trimmed = text.trimmed();
+	if (!trimmed.contains(u' ') && !trimmed.contains(u':'))
+	{
+		return searchIndex.find(trimmed, limit);
+	}
+
+	const UserSearchQuery	 query = UserSearchQuery::parse(trimmed);
+	const QList<UserRecord>& users = databaseModel->users();
+	QList<int>				 rows;
+
+	if (query.isEmpty())
+	{
+		return rows;
+	}
+	for (int row = 0; row < users.size() && rows.size() < limit; ++row)
+	{
+		if (query.matches(users.at(row)))
+		{
+			rows.append(row);
+		}
+	}
+	return rows;
+}
+
+void AdminWidget::showBrowseModel(QAbstractItemModel* model)
+{
+	browseModel = model;
+
+	if (databaseTable->model() == searchResultsModel)
+	{
+		// The results may show users that were just edited
+		sendSearch();
+		return;
+	}
+	showDatabaseModel(model);
+}
+
+void AdminWidget::selectUserRow(int row)
+{
+	const QModelIndex index = databaseTable->model()->index(row, 0);
+
+	databaseTable->selectionModel()->select(index, QItemSelectionModel::ClearAndSelect | QItemSelectionModel::Rows);
+	databaseTable->scrollTo(index, QAbstractItemView::PositionAtCenter);
+}
+
+void AdminWidget::setupSorting(QTableView* table, SortableTableModel* model)
+{
+	QHeaderView* header = table->horizontalHeader();
+	header->setSectionsClickable(true);
+	header->setSortIndicatorShown(false);
+
+	// Shift-click adds a column to the sort instead of replacing it
+	connect(header, &QHeaderView::sectionClicked, model, [table, model](int column) {
+		if (table->model() != model)
+		{
+			return;
+		}
+		model->toggleSortColumn(column, QGuiApplication::keyboardModifiers().testFlag(Qt::ShiftModifier));
+	});
+
+	// The header can only show the primary column
+	connect(model, &SortableTableModel::sorted, header, [header, model]() {
+		const QList<SortableTableModel::SortColumn>& columns = model->sortColumns();
+		header->setSortIndicatorShown(!columns.isEmpty());
+		if (!columns.isEmpty())
+		{
+			header->setSortIndicator(columns.first().column, columns.first().order);
+		}
+	});
+}
+
+void AdminWidget::showDatabaseModel(QAbstractItemModel* model)
+{
+	if (databaseTable->model() == model)
+	{
+		return;
+	}
+
+	QItemSelectionModel* previousSelection = databaseTable->selectionModel();
+	databaseTable->setModel(model);
+	delete previousSelection;
+
+	QHeaderView* header = databaseTable->horizontalHeader();
+	for (int column = 0; column < UserTableModel::ColumnCount; ++column)
+	{
+		header->setSectionResizeMode(column, QHeaderView::ResizeToContents);
+	}
+	// Set the last column to stretch to fill any remaining space
+	header->setSectionResizeMode(UserTableModel::ColumnCount - 1, QHeaderView::Stretch);
+	const SortableTableModel* sortable = qobject_cast<const SortableTableModel*>(model);
+	header->setSortIndicatorShown(sortable != nullptr && !sortable->sortColumns().isEmpty());
+
+	connect(databaseTable->selectionModel(), &QItemSelectionModel::selectionChanged, this,
+			&AdminWidget::onUserSelectionChanged);
+
+	loadVisibleUsers();
+}
+
+void AdminWidget::loadVisibleUsers()
+{
+	if (databaseTable->model() != pagedDatabaseModel)
+	{
+		return;
+	}
+
+	const int first = databaseTable->rowAt(0);
+	const int last = databaseTable->rowAt(databaseTable->viewport()->height() - 1);
+	if (first < 0)
+	{
+		return;
+	}
+
+	// Below the last row, the viewport shows every row up to the end
+	pagedDatabaseModel->ensureRowsLoaded(first, last < 0 ? pagedDatabaseModel->rowCount() - 1 : last);
+}
+
+const UserRecord* AdminWidget::userAtRow(int row) const
+{
+	if (databaseTable->model() == pagedDatabaseModel)
+	{
+		return pagedDatabaseModel->userAt(row);
+	}
+	if (databaseTable->model() == searchResultsModel)
+	{
+		return &searchResultsModel->userAt(row);
+	}
+	return &databaseModel->userAt(row);
+}
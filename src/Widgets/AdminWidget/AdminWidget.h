@@ -15,6 +15,8 @@
 #include <QLineEdit>
 #include <QStackedWidget>
 #include <QTableWidget>
+#include <QTableView>
+#include <QTimer>
 #include "qtmaterialtabs.h"
 #include "qtmaterialflatbutton.h"
 #include "qtmaterialdialog.h"
@@ -22,6 +24,12 @@
 #include "qtmaterialtextfield.h"
 #include "qtmaterialfab.h"
 #include "RequestManager.h"
+#include "ResponseManager.h"
+#include "UserTableModel.h"
+#include "TransactionTableModel.h"
+#include "UserSearchIndex.h"
+#include "PagedUserTableModel.h"
+#include "UserSearchQuery.h"
 
 #include <QVariantMap>
 
@@ -36,7 +44,10 @@
  * The AdminWidget communicates with the backend server through the RequestManager to perform various operations.
  *
  * The widget consists of:
- * - Database tab: Displays database content and allows users.
+ * - Database tab: Displays database content and allows users. Up to a configurable number of users the
+ *   search field looks them up in the rows already loaded, above it the search is sent to the server.
+ *   Users created, updated or deleted by anyone are pushed by the server and applied to the rows shown,
+ *   the changes received within a frame being applied at once.
  * - Transactions tab: Shows transaction history for all bank accounts (from -> to -> amount).
  * - Settings tab: Allows the admin to update their email address and password.
  */
@@ -55,6 +66,17 @@ public:
      */
 	AdminWidget(QString email, QString first_name, QWidget* parent = nullptr);
 
+	static constexpr int DefaultServerSearchThreshold = 5000; ///< Table size above which searches go to the server.
+	static constexpr int SearchResultLimit = 200;			  ///< Maximum number of users sent for a search.
+	static constexpr int ChangeCoalescingInterval = 16;		  ///< Milliseconds during which pushed changes are gathered.
+
+	/**
+     * @brief Sets the number of users above which the search is done by the server.
+     *
+     * @param rows The table size, a paged table is always searched by the server.
+     */
+	void setServerSearchThreshold(int rows);
+
 signals:
 	/**
      * @brief Signal emitted when the admin logs out.
@@ -65,16 +87,52 @@ public slots:
 	/**
      * @brief Slot for handling updates to the database content.
      *
-     * @param data The updated database content.
+     * @param page A page of users, or every user when the server does not page the database.
      */
-	void onDatabaseContentUpdated(const QList<QMap<QString, QString>>& data);
+	void onDatabaseContentUpdated(const UserPage& page);
 
 	/**
      * @brief Slot for handling fetched transaction history.
      *
-     * @param transactions The fetched transactions.
+     * @param page The fetched transactions.
+     */
+	void onTransactionsFetched(const TransactionPage& page);
+
+	/**
+     * @brief Slot for handling the users matching a search sent to the server.
+     *
+     * @param page The matching users.
      */
-	void onTransactionsFetched(const QList<QMap<QString, QString>>& transactions);
+	void onUsersFound(const UserPage& page);
+
+	/**
+     * @brief Slot for handling users changes pushed by the server, applied at the end of the frame.
+     *
+     * @param change The users changed.
+     */
+	void onUsersChanged(const UserChange& change);
+
+	/**
+     * @brief Slot for handling the reply to the subscription.
+     *
+     * @param requestId The RequestId of the Subscribe request.
+     * @param active Whether the server pushes users changes.
+     */
+	void onSubscriptionChanged(qint64 requestId, bool active);
+
+	/**
+     * @brief Slot for handling the connection state, subscribing again after a reconnection.
+     *
+     * @param connected Whether the client is connected.
+     */
+	void onConnectionChanged(bool connected);
+
+	/**
+     * @brief Slot for handling a "not modified" reply to a refresh.
+     *
+     * @param requestId The RequestId of the refresh.
+     */
+	void onResultUnchanged(qint64 requestId);
 
 	/**
      * @brief Slot for handling successful request messages.
@@ -121,6 +179,12 @@ private slots:
      */
 	void updateTransactionsTable();
 
+	/**
+     * @brief Slot to handle a refresh of the transactions model.
+     * @param newRows Number of transactions that were not shown before.
+     */
+	void onTransactionsRefreshed(int newRows);
+
 	/**
      * @brief Slot for handling the update user button click.
      */
@@ -141,7 +205,79 @@ private slots:
      */
 	void onUserSelectionChanged();
 
+	/**
+     * @brief Slot for selecting the first user matching the search field.
+     */
+	void onSearchTextChanged(const QString& text);
+
+	/**
+     * @brief Slot for selecting the next user matching the search field.
+     */
+	void onSearchNext();
+
+	/**
+     * @brief Slot for sending the search typed in the search field to the server.
+     */
+	void sendSearch();
+
+	/**
+     * @brief Slot for applying the users changes gathered since the last frame.
+     */
+	void applyPendingChanges();
+
+	/**
+     * @brief Slot for loading the pages of the users shown, when the paged database is shown.
+     */
+	void loadVisibleUsers();
+
 private:
+	/**
+     * @brief Asks the server to push the changes made to the users.
+     */
+	void subscribe();
+
+	/**
+     * @brief Tells whether the search field is handled by the server rather than by the search index.
+     */
+	bool usesServerSearch() const;
+
+	/**
+     * @brief Finds the rows of the database model matching a search, as the server would.
+     *
+     * A single bare term is looked up in the search index, other queries are checked on every user,
+     * which stays cheap below the server search threshold.
+     *
+     * @param text The search text.
+     * @param limit Maximum number of rows returned.
+     * @return The matching source rows, in ascending order.
+     */
+	QList<int> findLocalUsers(const QString& text, int limit) const;
+
+	/**
+     * @brief Shows a model holding the database, unless search results are shown in its place.
+     */
+	void showBrowseModel(QAbstractItemModel* model);
+
+	/**
+     * @brief Selects a row of the database table and scrolls it into view.
+     */
+	void selectUserRow(int row);
+
+	/**
+     * @brief Sorts a table when its header is clicked, shift-click adding secondary columns.
+     */
+	void setupSorting(QTableView* table, SortableTableModel* model);
+
+	/**
+     * @brief Shows a model in the database table, either the snapshot model or the paged model.
+     */
+	void showDatabaseModel(QAbstractItemModel* model);
+
+	/**
+     * @brief Returns the user shown at a row of the database table, or nullptr if not loaded yet.
+     */
+	const UserRecord* userAtRow(int row) const;
+
 	/**
      * @brief Creates the widget for the database management tab.
      *
@@ -178,8 +314,19 @@ private:
 	QString						  admin_email_;		  ///< The email of the admin.
 	QString						  admin_new_email_;	  ///< The potential new email of the admin.
 	QString						  admin_first_name_;  ///< The first name of the admin.
-	QList<QMap<QString, QString>> transactions_;	  ///< List of transactions.
-	QList<QMap<QString, QString>> databaseContent_;	  ///< List of database content.
+	UserTableModel*				  databaseModel;	  ///< Model holding the database content.
+	PagedUserTableModel*		  pagedDatabaseModel; ///< Model loading the database page by page.
+	UserSearchIndex				  searchIndex;		  ///< Lookup structures over the database content.
+	UserTableModel*				  searchResultsModel; ///< Model holding the users found by the server.
+	QAbstractItemModel*			  browseModel;		  ///< The database model shown when no search results are.
+	QTimer*						  searchTimer;		  ///< Delays the server search until typing pauses.
+	qint64						  pendingSearchRequest; ///< RequestId of the search in flight, -1 if none.
+	int							  serverSearchThreshold; ///< Table size above which searches go to the server.
+	QList<UserChange>			  pendingChanges;	  ///< Users changes not applied yet, in the order received.
+	QTimer*						  changeTimer;		  ///< Applies the pending changes once per frame.
+	qint64						  pendingSubscribeRequest; ///< RequestId of the subscription in flight, -1 if none.
+	bool						  subscribed;		  ///< Whether the server pushes users changes.
+	TransactionTableModel*		  transactionsModel;  ///< Model holding the transaction history.
 	RequestManager*				  requestManager;	  ///< The request manager for handling server requests.
 
 	QtMaterialFlatButton* welcomeLabel;				  ///< Welcome label showing admin's first name.
@@ -188,14 +335,16 @@ private:
 	QStackedWidget*		  tabContents;				  ///< Stacked widget to hold tab content.
 	QtMaterialDialog*	  logoutDialog;				  ///< Dialog for confirming logout.
 
-	QTableWidget* databaseTable;					  ///< Table widget for displaying database content.
-	QTableWidget* transactionsTable;				  ///< Table widget for displaying transactions.
+	QtMaterialTextField* searchField;				  ///< Search field above the database table.
+	QTableView*			 databaseTable;				  ///< Table view for displaying database content.
+	QTableView*			 transactionsTable;			  ///< Table view for displaying transactions.
 
 	QtMaterialFloatingActionButton* updateUserFab;	  ///< Floating action button for updating a user.
 	QtMaterialFloatingActionButton* deleteUserFab;	  ///< Floating action button for deleting a user.
 	QtMaterialFloatingActionButton* createNewUserFab; ///< Floating action button for creating a new user.
 
-	QVariantMap selectedUserData;					  ///< Data of the currently selected user.
+	UserRecord selectedUser;						  ///< The currently selected user.
+	bool	   hasSelectedUser;						  ///< Whether a single user is selected.
 };
 
 #endif												  // ADMINWIDGET_H
@@ -141,7 +141,11 @@ void LoginWidget::onLoginButton()
 		return;
 	}
 
-	requestManager->createRequest(RequestManager::Login, loginData);
+	// Servers supporting it answer with the UserInit payload, saving a round trip
+	QVariantMap request = loginData;
+	request.insert("init", true);
+
+	requestManager->createRequest(RequestManager::Login, request);
 }
 
 void LoginWidget::onLoginTextChanged()
@@ -218,12 +222,11 @@ void LoginWidget::onSuccessfullRequest(QString message)
 	notificationSnackbar->setBackgroundColor(QColor(0, 255, 0, 100));
 
 	notificationSnackbar->addMessage(message);
+}
 
-	//if the message string contains "Login Successfull" then emit the signal to the UIManager
-	if (message.contains("Login Successfull"))
-	{
-		requestManager->createRequest(RequestManager::UserInit, loginData);
-	}
+void LoginWidget::onLoginAccepted()
+{
+	requestManager->createRequest(RequestManager::UserInit, loginData);
 }
 
 void LoginWidget::clearFields()
@@ -49,12 +49,6 @@ signals:
      */
 	void disconnectFromServer();
 
-	/**
-     * @brief Signal emitted to send login request.
-     * @param loginData The JSON object containing login data.
-     */
-	void sendLoginRequest(QJsonObject loginData);
-
 public slots:
 	/**
      * @brief Slot to handle successful connection to the server.
@@ -78,6 +72,11 @@ public slots:
      */
 	void onSuccessfullRequest(QString message);
 
+	/**
+     * @brief Slot to request the UserInit payload from servers that did not send it with the login reply.
+     */
+	void onLoginAccepted();
+
 	/**
      * @brief Clears the input fields for email and password.
      */
@@ -10,9 +10,11 @@
 #include "UpdatePasswordDialog.h"
 
 #include "ValidationStrategy.h"
+#include "UserSearchQuery.h"
 
 UserWidget::UserWidget(QString email, QString first_name, QString account_number, QString balance, QWidget* parent) :
 	QWidget(parent), email_(email), first_name_(first_name), account_number_(account_number), balance_(balance),
+	pendingBalanceRequest_(-1), pendingSubscribeRequest_(-1), subscribed_(false), pendingRecipientRequest_(-1),
 	requestManager(RequestManager::getInstance(this))
 {
 	// set object name
@@ -63,8 +65,16 @@ UserWidget::UserWidget(QString email, QString first_name, QString account_number
 	connect(toAccountField, &QtMaterialTextField::textChanged, this, &UserWidget::onTransferFieldsChanged);
 	connect(toEmailField, &QtMaterialTextField::textChanged, this, &UserWidget::onTransferFieldsChanged);
 	connect(amountField, &QtMaterialTextField::textChanged, this, &UserWidget::onTransferFieldsChanged);
+	// Connected after onTransferFieldsChanged, which validates the account number first
+	connect(toAccountField, &QtMaterialTextField::textChanged, this, &UserWidget::onRecipientChanged);
+	connect(recipientTimer, &QTimer::timeout, this, &UserWidget::lookUpRecipient);
 
-	onBalanceFetched(balance_);
+	subscribe();
+
+	// The first page of history and a fresh balance are requested right away, without waiting for each
+	// other, so that the Home tab is filled on first paint
+	transactionsModel->refresh();
+	requestBalance();
 }
 
 QWidget* UserWidget::createHomeTab()
@@ -78,9 +88,12 @@ QWidget* UserWidget::createHomeTab()
 	welcomeLabel->setFont(QFont("Fira Sans", 16, QFont::ExtraBold));
 	layout->addWidget(welcomeLabel);
 
-	transactionsTable = new QTableWidget(homeTab);
-	transactionsTable->setColumnCount(4);
-	transactionsTable->setHorizontalHeaderLabels({"From Account", "To Account", "Amount", "Date of Transaction"});
+	// Pages of history are requested as the table is scrolled to its end
+	transactionsModel = new TransactionTableModel(QVariantMap(), this);
+	connect(transactionsModel, &TransactionTableModel::refreshed, this, &UserWidget::onTransactionsRefreshed);
+
+	transactionsTable = new QTableView(homeTab);
+	transactionsTable->setModel(transactionsModel);
 	transactionsTable->setGridStyle(Qt::NoPen);
 	transactionsTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
 	transactionsTable->setSelectionBehavior(QAbstractItemView::SelectRows);
@@ -88,6 +101,7 @@ QWidget* UserWidget::createHomeTab()
 	transactionsTable->setAlternatingRowColors(true);
 	transactionsTable->verticalHeader()->setVisible(false);
 	transactionsTable->horizontalHeader()->setStretchLastSection(true);
+	transactionsTable->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
 
 	// Set column width ratio
 	transactionsTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
@@ -128,6 +142,15 @@ QWidget* UserWidget::createTransferTab()
 	amountField->setFont(QFont("Fira Sans", 16, QFont::ExtraBold));
 	amountField->setLabelColor(QColor("#222831"));
 
+	// The owner of the account typed is looked up once typing pauses
+	recipientLabel = new QLabel(this);
+	recipientLabel->setAlignment(Qt::AlignCenter);
+	recipientLabel->setFont(QFont("Fira Sans", 14));
+
+	recipientTimer = new QTimer(this);
+	recipientTimer->setSingleShot(true);
+	recipientTimer->setInterval(250);
+
 	transferButton = new QtMaterialFlatButton("Transfer", Material::ButtonTextSecondary, this);
 
 	transferButton->setDisabled(true); // Initially disabled until all fields are filled
@@ -150,6 +173,7 @@ QWidget* UserWidget::createTransferTab()
 	QVBoxLayout* layout = createTabLayout();
 	layout->addSpacing(50);
 	layout->addLayout(toAccountEmailLayout);
+	layout->addWidget(recipientLabel);
 	layout->addSpacing(20);
 	layout->addWidget(amountField);
 	layout->addStretch(1);
@@ -272,6 +296,7 @@ void UserWidget::onUpdateEmail()
 			return;
 		}
 
+		new_email_ = data["new_email"].toString();
 		requestManager->createRequest(RequestManager::UpdateEmail, data);
 	}
 }
@@ -326,64 +351,110 @@ void UserWidget::onLogoutConfirmed()
 void UserWidget::updateTransactionsTable()
 {
 	// Send the request to get the transaction history
-	if (tabContents->currentIndex() == 0)
+	if (tabContents->currentIndex() == 0 && !(subscribed_ && transactionsModel->hasLoaded()))
 	{
-		requestManager->createRequest(RequestManager::GetTransactionsHistory, QVariantMap({{"email", email_}}));
+		transactionsModel->refresh();
 	}
 }
 
-void UserWidget::onTransactionsFetched(const QList<QMap<QString, QString>>& transactions)
+void UserWidget::onTransactionsFetched(const TransactionPage& page)
 {
-	transactions_ = transactions;
-
-	transactionsTable->setRowCount(0); // Clear existing rows
-	transactionsTable->selectedItems().isEmpty();
+	transactionsModel->applyPage(page);
+}
 
-	for (const auto& transaction: transactions_)
+void UserWidget::onTransactionsRefreshed(int newRows)
+{
+	if (newRows > 0)
 	{
-		int row = transactionsTable->rowCount();
-		transactionsTable->insertRow(row);
-
-		QTableWidgetItem* fromAccountItem = new QTableWidgetItem(transaction["from_account_number"]);
-		QTableWidgetItem* toAccountItem = new QTableWidgetItem(transaction["to_account_number"]);
-		QTableWidgetItem* amountItem = new QTableWidgetItem(transaction["transaction_amount"]);
-		QTableWidgetItem* dateItem = new QTableWidgetItem(transaction["created_at"]);
-
-		transactionsTable->setItem(row, 0, fromAccountItem);
-		transactionsTable->setItem(row, 1, toAccountItem);
-		transactionsTable->setItem(row, 2, amountItem);
-		transactionsTable->setItem(row, 3, dateItem);
+		onSuccessfullRequest("Transactions updated Successfully");
 	}
+}
 
-	// Ensure columns resize to fit content but don't leave excess space
-	for (int column = 0; column < transactionsTable->columnCount(); ++column)
+void UserWidget::onBalanceLabelClicked()
+{
+	requestBalance();
+}
+
+void UserWidget::requestBalance()
+{
+	// Send the request to get the balance
+	QVariantMap data;
+	data["account_number"] = account_number_.toInt();
+	if (!balanceVersion_.isNull())
 	{
-		transactionsTable->horizontalHeader()->setSectionResizeMode(column, QHeaderView::ResizeToContents);
+		data["if_version"] = balanceVersion_;
 	}
-	// Set the last column to stretch to fill any remaining space
-	transactionsTable->horizontalHeader()->setSectionResizeMode(transactionsTable->columnCount() - 1,
-																QHeaderView::Stretch);
+	requestManager->createRequest(RequestManager::GetBalance, data);
+	pendingBalanceRequest_ = requestManager->lastRequestId();
+}
 
-	// Optionally, you can force a resize to contents for better accuracy
-	// transactionsTable->resizeColumnsToContents(); // This might not be necessary if resize mode is set correctly
+void UserWidget::onBalanceFetched(const QString balance, const QVariant& version)
+{
+	balance_ = balance;
+	balanceVersion_ = version;
+	pendingBalanceRequest_ = -1;
+	balanceLabel->setText("Current Balance: $" + balance_);
 
-	onSuccessfullRequest("Transactions updated Successfully");
+	onSuccessfullRequest("Balance updated Successfully");
 }
 
-void UserWidget::onBalanceLabelClicked()
+void UserWidget::onResultUnchanged(qint64 requestId)
+{
+	if (requestId != -1 && requestId == pendingBalanceRequest_)
+	{
+		// The balance shown is still current
+		pendingBalanceRequest_ = -1;
+		onSuccessfullRequest("Balance updated Successfully");
+		return;
+	}
+
+	transactionsModel->applyNotModified(requestId);
+}
+
+void UserWidget::subscribe()
 {
-	// Send the request to get the balance
 	QVariantMap data;
 	data["account_number"] = account_number_.toInt();
-	requestManager->createRequest(RequestManager::GetBalance, data);
+	data["topics"] = QStringList({"balance", "transactions"});
+	requestManager->createRequest(RequestManager::Subscribe, data);
+	pendingSubscribeRequest_ = requestManager->lastRequestId();
+}
+
+void UserWidget::onSubscriptionChanged(qint64 requestId, bool active)
+{
+	if (requestId == -1 || requestId != pendingSubscribeRequest_)
+	{
+		return;
+	}
+
+	// Without a subscription the Home tab keeps asking for new transactions
+	pendingSubscribeRequest_ = -1;
+	subscribed_ = active;
 }
 
-void UserWidget::onBalanceFetched(const QString balance)
+void UserWidget::onBalanceChanged(const QString balance, const QVariant& version)
 {
 	balance_ = balance;
+	balanceVersion_ = version;
 	balanceLabel->setText("Current Balance: $" + balance_);
+}
 
-	onSuccessfullRequest("Balance updated Successfully");
+void UserWidget::onTransactionsPushed(const TransactionPage& page)
+{
+	transactionsModel->applyPushed(page);
+}
+
+void UserWidget::onConnectionChanged(bool connected)
+{
+	if (connected)
+	{
+		subscribe();
+		return;
+	}
+
+	// Events may have been missed while disconnected, the next refresh catches up
+	subscribed_ = false;
+	pendingSubscribeRequest_ = -1;
 }
 
 void UserWidget::updateFirstNameLabel()
@@ -461,6 +532,54 @@ void UserWidget::onTransferButtonClicked()
 	}
 }
 
+void UserWidget::onRecipientChanged()
+{
+	// Only an account number needs its owner to be shown, an email already names the recipient
+	recipientLabel->clear();
+	pendingRecipientRequest_ = -1;
+
+	if (toAccountField->inputLineColor() == Qt::green)
+	{
+		recipientTimer->start();
+	}
+	else
+	{
+		recipientTimer->stop();
+	}
+}
+
+void UserWidget::lookUpRecipient()
+{
+	UserSearchQuery query;
+	query.minAccount = toAccountField->text().toLongLong();
+	query.maxAccount = query.minAccount;
+
+	QVariantMap data = query.toVariantMap();
+	data.insert("limit", 1);
+
+	// Only the name is shown, the rest of the record is not sent
+	requestManager->createRequest(RequestManager::SearchUsers, data,
+								  UserRecord::fieldNames(UserRecord::FirstNameField | UserRecord::LastNameField));
+	pendingRecipientRequest_ = requestManager->lastRequestId();
+}
+
+void UserWidget::onUsersFound(const UserPage& page)
+{
+	// Only the reply to the last account typed is shown
+	if (page.requestId == -1 || page.requestId != pendingRecipientRequest_)
+	{
+		return;
+	}
+	pendingRecipientRequest_ = -1;
+
+	if (page.users.isEmpty())
+	{
+		recipientLabel->setText("No account " + toAccountField->text());
+		return;
+	}
+	recipientLabel->setText("To " + page.users.first().firstName + " " + page.users.first().lastName);
+}
+
 void UserWidget::onSuccessfullRequest(QString message)
 {
 	// show snackbar message
@@ -471,6 +590,9 @@ void UserWidget::onSuccessfullRequest(QString message)
 	if (message == "Email updated successfully")
 	{
 		email_ = new_email_;
+
+		// Requests sent without a session token identify the user by email
+		requestManager->openSession(email_);
 	}
 }
 
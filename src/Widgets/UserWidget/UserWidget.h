@@ -13,7 +13,8 @@
 #include <QLabel>
 #include <QLineEdit>
 #include <QStackedWidget>
-#include <QTableWidget>
+#include <QTableView>
+#include <QTimer>
 #include "qtmaterialtabs.h"
 #include "qtmaterialflatbutton.h"
 #include "qtmaterialdialog.h"
@@ -21,6 +22,8 @@
 #include "qtmaterialtextfield.h"
 
 #include "RequestManager.h"
+#include "ResponseManager.h"
+#include "TransactionTableModel.h"
 
 /**
  * @class UserWidget
@@ -63,16 +66,55 @@ signals:
 
 public slots:
 	/**
-     * @brief Slot to handle successful fetch of transactions.
-     * @param transactions The list of transactions fetched from the server.
+     * @brief Slot to handle successful fetch of a page of transactions.
+     * @param page The page fetched from the server.
      */
-	void onTransactionsFetched(const QList<QMap<QString, QString>>& transactions);
+	void onTransactionsFetched(const TransactionPage& page);
 
 	/**
      * @brief Slot to handle successful fetch of balance.
      * @param balance The balance fetched from the server.
+     * @param version The "version" of the balance, sent back with the next request.
      */
-	void onBalanceFetched(const QString balance);
+	void onBalanceFetched(const QString balance, const QVariant& version = QVariant());
+
+	/**
+     * @brief Slot to handle a "not modified" reply to a refresh.
+     * @param requestId The RequestId of the refresh.
+     */
+	void onResultUnchanged(qint64 requestId);
+
+	/**
+     * @brief Slot to handle the reply to the subscription.
+     * @param requestId The RequestId of the Subscribe request.
+     * @param active Whether the server pushes balance and transaction events.
+     */
+	void onSubscriptionChanged(qint64 requestId, bool active);
+
+	/**
+     * @brief Slot to handle a balance pushed by the server.
+     * @param balance The new balance.
+     * @param version The "version" of the balance.
+     */
+	void onBalanceChanged(const QString balance, const QVariant& version);
+
+	/**
+     * @brief Slot to handle transactions pushed by the server.
+     * @param page The new transactions.
+     */
+	void onTransactionsPushed(const TransactionPage& page);
+
+	/**
+     * @brief Slot to handle the reply to the recipient lookup.
+     * @param page The users found, with their names only.
+     */
+	void onUsersFound(const UserPage& page);
+
+	/**
+     * @brief Slot to handle the connection state, subscribing again after a reconnection.
+     * @param connected Whether the client is connected.
+     */
+	void onConnectionChanged(bool connected);
 
 	/**
      * @brief Slot to handle successful request.
@@ -108,10 +150,18 @@ private slots:
 	void onLogoutConfirmed();
 
 	/**
-     * @brief Updates the transactions table with fetched data.
+     * @brief Asks for transactions made since the last update when the Home tab is shown.
+     *
+     * Once subscribed, new transactions are pushed and only the first page is requested.
      */
 	void updateTransactionsTable();
 
+	/**
+     * @brief Slot to handle a refresh of the transactions model.
+     * @param newRows Number of transactions that were not shown before.
+     */
+	void onTransactionsRefreshed(int newRows);
+
 	/**
      * @brief Slot to handle balance label click.
      */
@@ -132,7 +182,27 @@ private slots:
      */
 	void onTransferButtonClicked();
 
+	/**
+     * @brief Slot to handle changes of the account number to transfer to, clearing the name shown.
+     */
+	void onRecipientChanged();
+
+	/**
+     * @brief Asks the server for the name of the owner of the account typed in the transfer tab.
+     */
+	void lookUpRecipient();
+
 private:
+	/**
+     * @brief Asks the server to push balance and transaction events of the account.
+     */
+	void subscribe();
+
+	/**
+     * @brief Requests the balance, with the version of the one shown.
+     */
+	void requestBalance();
+
 	/**
      * @brief Creates the Home tab widget.
      * @return The Home tab widget.
@@ -162,7 +232,12 @@ private:
 	QString						  first_name_;	   ///< The user's first name.
 	QString						  account_number_; ///< The user's account number.
 	QString						  balance_;		   ///< The user's current balance.
-	QList<QMap<QString, QString>> transactions_;   ///< List of transactions.
+	QVariant					  balanceVersion_; ///< "version" of the balance shown, null if unknown.
+	qint64						  pendingBalanceRequest_; ///< RequestId of the balance request in flight, -1 if none.
+	TransactionTableModel*		  transactionsModel; ///< Model of the transaction history, loaded page by page.
+	qint64						  pendingSubscribeRequest_; ///< RequestId of the subscription in flight, -1 if none.
+	bool						  subscribed_;	   ///< Whether the server pushes balance and transaction events.
+	qint64						  pendingRecipientRequest_; ///< RequestId of the recipient lookup, -1 if none.
 
 	RequestManager* requestManager;				   ///< The request manager for communication with the server.
 
@@ -177,7 +252,9 @@ private:
 	QtMaterialTextField*  toEmailField;			   ///< Text field for entering the email address to transfer to.
 	QtMaterialTextField*  amountField;			   ///< Text field for entering the amount to transfer.
 	QtMaterialFlatButton* transferButton;		   ///< Button to initiate the transfer.
-	QTableWidget*		  transactionsTable;	   ///< Table displaying transaction history.
+	QLabel*				  recipientLabel;		   ///< Label showing the name of the owner of the account typed.
+	QTimer*				  recipientTimer;		   ///< Delays the recipient lookup until typing pauses.
+	QTableView*			  transactionsTable;	   ///< Table displaying transaction history.
 };
 
 #endif											   // USERWIDGET_H
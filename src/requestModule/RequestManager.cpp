@@ -1,6 +1,9 @@
 #include "RequestManager.h"
 
-RequestManager::RequestManager(QObject* parent) : QObject(parent)
+#include <QDebug>
+#include <QJsonArray>
+
+RequestManager::RequestManager(QObject* parent) : QObject(parent), nextRequestId(1), backpressured(false)
 {
 }
 
@@ -10,18 +13,134 @@ RequestManager* RequestManager::getInstance(QObject* parent)
 	return instance;
 }
 
-void RequestManager::createRequest(AvailableRequests requestType, QVariantMap data)
+bool RequestManager::createRequest(AvailableRequests requestType, QVariantMap data, const QStringList& fields)
 {
 	QJsonObject request;
 	request.insert("Request", requestType);
+	request.insert("RequestId", nextRequestId++);
 	QJsonObject requestData;
 
+	// The token identifies the user, otherwise the email does unless the request names one itself
+	if (!sessionToken_.isEmpty())
+	{
+		request.insert("Session", sessionToken_);
+	}
+	else if (!sessionEmail_.isEmpty() && !data.contains("email"))
+	{
+		requestData.insert("email", sessionEmail_);
+	}
+
 	for (auto it = data.constBegin(); it != data.constEnd(); ++it)
 	{
 		requestData.insert(it.key(), QJsonValue::fromVariant(it.value()));
 	}
 
+	if (!fields.isEmpty())
+	{
+		requestData.insert("fields", QJsonArray::fromStringList(fields));
+	}
+
 	request.insert("Data", requestData);
 
-	emit makeRequest(request);
+	MessagePtr message = NetworkMessage::fromEnvelope(request);
+
+	if (backpressured)
+	{
+		// The reply to the earlier copy of a refresh would be ignored, its caller waits for this one
+		if (isRead(requestType))
+		{
+			deferredRequests.removeIf([&request](const MessagePtr& deferred) {
+				return deferred->envelope().value("Request") == request.value("Request") &&
+					   deferred->envelope().value("Data") == request.value("Data");
+			});
+		}
+
+		if (deferredRequests.size() >= MaxDeferredRequests)
+		{
+			qWarning() << "Request" << lastRequestId() << "dropped," << deferredRequests.size() << "requests deferred";
+			emit requestDropped(lastRequestId());
+			return false;
+		}
+
+		deferredRequests.append(message);
+		return false;
+	}
+
+	emit makeRequest(message);
+	return true;
+}
+
+void RequestManager::openSession(const QString& email)
+{
+	sessionEmail_ = email;
+}
+
+void RequestManager::closeSession()
+{
+	sessionToken_.clear();
+	sessionEmail_.clear();
+}
+
+void RequestManager::setSessionToken(const QString& token)
+{
+	sessionToken_ = token;
+}
+
+void RequestManager::onSessionExpired()
+{
+	sessionToken_.clear();
+}
+
+QString RequestManager::sessionToken() const
+{
+	return sessionToken_;
+}
+
+qint64 RequestManager::lastRequestId() const
+{
+	return nextRequestId - 1;
+}
+
+bool RequestManager::isRead(AvailableRequests requestType)
+{
+	switch (requestType)
+	{
+		case GetAccountnumber:
+		case GetBalance:
+		case GetTransactionsHistory:
+		case GetDatabase:
+		case SearchUsers:
+		case Subscribe:
+			return true;
+		default:
+			return false;
+	}
+}
+
+bool RequestManager::isBackpressured() const
+{
+	return backpressured;
+}
+
+void RequestManager::onBackpressureChanged(bool congested)
+{
+	if (backpressured == congested)
+	{
+		return;
+	}
+
+	backpressured = congested;
+	emit backpressureChanged(congested);
+
+	if (!backpressured)
+	{
+		// Release what was held back, in the order it was created
+		QList<MessagePtr> pending;
+		pending.swap(deferredRequests);
+
+		for (const MessagePtr& request: pending)
+		{
+			emit makeRequest(request);
+		}
+	}
 }
\ No newline at end of file
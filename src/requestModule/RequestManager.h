@@ -10,10 +10,13 @@
 
 #include <QJsonObject>
 #include <QString>
+#include <QStringList>
 #include <QMap>
 #include <QVariantMap>
 #include <QVariant>
 #include <QObject>
+#include <QList>
+#include "NetworkMessage.h"
 
 /**
  * @class RequestManager
@@ -26,6 +29,13 @@
  * The requests are defined by the AvailableRequests enum and include operations such as user login,
  * account retrieval, balance checking, transaction history, and more. The requests are created
  * in the form of QJsonObject and emitted via the makeRequest signal.
+ *
+ * While the network layer reports backpressure, new requests are held back in creation order and
+ * released as soon as the outbound queue has drained.
+ *
+ * Once logged in, requests are made on behalf of the session's user: when the server gave a session
+ * token, it is sent as "Session" in every envelope; otherwise the user's "email" is added to the
+ * request data. Callers do not add these identity fields themselves.
  */
 class RequestManager : public QObject
 {
@@ -43,9 +53,43 @@ signals:
 	/**
 	 * @brief Signal emitted when a request is made.
 	 *
-	 * @param Data The QJsonObject representing the request data.
+	 * @param request The request, shared with every later stage of the pipeline.
 	 */
-	void makeRequest(QJsonObject Data);
+	void makeRequest(MessagePtr request);
+
+	/**
+	 * @brief Signal emitted when requests start or stop being held back.
+	 *
+	 * @param congested true while new requests are deferred.
+	 */
+	void backpressureChanged(bool congested);
+
+	/**
+	 * @brief Signal emitted when a request is dropped because too many requests are deferred.
+	 *
+	 * @param requestId The "RequestId" given to the dropped request, no reply will carry it.
+	 */
+	void requestDropped(qint64 requestId);
+
+public slots:
+	/**
+	 * @brief Slot to handle backpressure reported by the network layer.
+	 *
+	 * @param congested true when the outbound queue is above its high-water mark.
+	 */
+	void onBackpressureChanged(bool congested);
+
+	/**
+	 * @brief Slot to set the session token sent with every request.
+	 *
+	 * @param token The token returned at login.
+	 */
+	void setSessionToken(const QString& token);
+
+	/**
+	 * @brief Slot to forget a token the server no longer accepts, falling back to the email.
+	 */
+	void onSessionExpired();
 
 public:
 	// Delete the copy constructor and assignment operator to prevent copying
@@ -60,6 +104,8 @@ public:
 	 */
 	static RequestManager* getInstance(QObject* parent = nullptr);
 
+	static constexpr int MaxDeferredRequests = 256; ///< Number of requests held back at most while backpressured.
+
 	/**
 	 * @enum AvailableRequests
 	 * @brief Defines the types of requests that can be created.
@@ -80,16 +126,78 @@ public:
 		UserInit,			///< Request to initialize user
 		UpdateEmail,		///< Request to update user email
 		UpdatePassword,		///< Request to update user password
+		Handshake,			///< Wire codec negotiation, sent by the ClientHandler after connecting
+		SearchUsers,		///< Request for the users matching a UserSearchQuery
+		Subscribe,			///< Request for events to be pushed on the given "topics"
 		JsonParseError = -1 ///< Indicates a JSON parse error
 	};
 
 	/**
 	 * @brief Creates a request based on the provided type and data.
 	 *
+	 * Every request carries a unique, monotonically increasing "RequestId" which the server echoes
+	 * back in its reply, so that several requests can be in flight at the same time.
+	 *
+	 * When fields are given, they are sent as "fields" and the server only sends those fields of the
+	 * rows of its reply. Fields left out keep their default value once decoded.
+	 *
+	 * While backpressured, requests are deferred. A read deferred again with the same data replaces
+	 * the earlier copy, so that repeated refreshes are sent once, with the RequestId the caller kept.
+	 * Beyond MaxDeferredRequests, the request is dropped and requestDropped() is emitted.
+	 *
 	 * @param requestType The type of request to create, defined by AvailableRequests enum.
 	 * @param data The data to be included in the request, in the form of QVariantMap.
+	 * @param fields Names of the row fields wanted in the reply, empty for every field.
+	 * @return true if the request was dispatched, false if it was deferred or dropped because of backpressure.
 	 */
-	void createRequest(AvailableRequests requestType, QVariantMap data);
+	bool createRequest(AvailableRequests requestType, QVariantMap data, const QStringList& fields = QStringList());
+
+	/**
+	 * @brief Returns the "RequestId" given to the last created request.
+	 *
+	 * Callers that need to recognize the reply to their own request read it right after createRequest().
+	 *
+	 * @return The identifier, 0 if no request was created yet.
+	 */
+	qint64 lastRequestId() const;
+
+	/**
+	 * @brief Starts making requests on behalf of a user.
+	 *
+	 * Called again with the new email once the user changes it, the session token, if any, is kept.
+	 *
+	 * @param email The email identifying the user when no session token is known.
+	 */
+	void openSession(const QString& email);
+
+	/**
+	 * @brief Stops adding identity fields to requests, forgetting the token and the email.
+	 */
+	void closeSession();
+
+	/**
+	 * @brief Returns the session token, empty if none.
+	 */
+	QString sessionToken() const;
+
+	/**
+	 * @brief Checks whether new requests are currently held back.
+	 *
+	 * @return true while the network layer reports backpressure.
+	 */
+	bool isBackpressured() const;
+
+private:
+	/**
+	 * @brief Tells whether a request only reads data, so that sending it twice is the same as once.
+	 */
+	static bool isRead(AvailableRequests requestType);
+
+	qint64			   nextRequestId;	 ///< Identifier given to the next created request.
+	bool			   backpressured;	 ///< Whether the network layer asked to hold requests back.
+	QList<MessagePtr> deferredRequests; ///< Requests created while backpressured, in creation order.
+	QString			   sessionToken_;	 ///< Token sent as "Session" in every envelope, empty if none.
+	QString			   sessionEmail_;	 ///< Email added to the requests when there is no token.
 };
 
 #endif // REQUESTMANAGER_H
@@ -0,0 +1,508 @@
+/**
+ * @file ResponseDecoder.cpp
+ * @brief Implementation file for the ResponseDecoder class.
+ */
+#include "ResponseDecoder.h"
+#include "ResponseManager.h"
+#include "JsonStreamReader.h"
+
+#include <QAnyStringView>
+#include <QCborStreamReader>
+#include <QCborValue>
+#include <QJsonArray>
+#include <QJsonDocument>
+
+namespace
+{
+/**
+ * @enum Field
+ * @brief The row fields understood by the decoder.
+ */
+enum class Field
+{
+	Unknown,
+	FirstName,
+	LastName,
+	Email,
+	Role,
+	AccountNumber,
+	Balance,
+	FromAccountNumber,
+	ToAccountNumber,
+	Amount,
+	CreatedAt
+};
+
+Field fieldOf(QAnyStringView key)
+{
+	static const struct
+	{
+		QLatin1String name;
+		Field		  field;
+	} fields[] = {
+		{QLatin1String("first_name"), Field::FirstName},
+		{QLatin1String("last_name"), Field::LastName},
+		{QLatin1String("email"), Field::Email},
+		{QLatin1String("role"), Field::Role},
+		{QLatin1String("account_number"), Field::AccountNumber},
+		{QLatin1String("balance"), Field::Balance},
+		{QLatin1String("from_account_number"), Field::FromAccountNumber},
+		{QLatin1String("to_account_number"), Field::ToAccountNumber},
+		{QLatin1String("amount"), Field::Amount},
+		{QLatin1String("created_at"), Field::CreatedAt},
+	};
+
+	for (const auto& entry : fields)
+	{
+		if (key.size() == entry.name.size() && key == entry.name)
+		{
+			return entry.field;
+		}
+	}
+	return Field::Unknown;
+}
+
+qint64 toAccountNumber(const QJsonValue& value)
+{
+	return value.isString() ? value.toString().toLongLong() : static_cast<qint64>(value.toDouble());
+}
+
+qint64 toCents(const QJsonValue& value)
+{
+	return TransactionStore::toCents(value.isString() ? value.toString().toDouble() : value.toDouble());
+}
+
+quint8 setUserField(UserRecord& row, Field field, const QJsonValue& value, StringPool& strings)
+{
+	switch (field)
+	{
+		case Field::FirstName:
+			row.firstName = strings.intern(value.toString());
+			return UserRecord::FirstNameField;
+		case Field::LastName:
+			row.lastName = strings.intern(value.toString());
+			return UserRecord::LastNameField;
+		case Field::Email:
+			row.email = value.toString();
+			return UserRecord::EmailField;
+		case Field::Role:
+			row.role = UserRecord::roleFromString(value.toString());
+			return UserRecord::RoleField;
+		case Field::AccountNumber:
+			row.accountNumber = toAccountNumber(value);
+			return UserRecord::AccountNumberField;
+		case Field::Balance:
+			row.balanceCents = toCents(value);
+			return UserRecord::BalanceField;
+		default:
+			return 0;
+	}
+}
+
+quint8 setTransactionField(TransactionStore::Row& row, Field field, const QJsonValue& value, StringPool&)
+{
+	switch (field)
+	{
+		case Field::FromAccountNumber:
+			row.fromAccount = toAccountNumber(value);
+			break;
+		case Field::ToAccountNumber:
+			row.toAccount = toAccountNumber(value);
+			break;
+		case Field::Amount:
+			row.amountCents = toCents(value);
+			break;
+		case Field::CreatedAt:
+			row.createdAt = TransactionStore::parseTimestamp(value.toString());
+			break;
+		default:
+			break;
+	}
+	return 0;
+}
+
+/**
+ * @struct RowSchema
+ * @brief How the rows of one list are built.
+ *
+ * Rows start as a copy of the defaults, so that every column is set even when the server omits it.
+ * Text repeated across rows is shared through the pool given to set, which returns the flag of the
+ * field it set, if the record has such flags.
+ */
+template <typename Record>
+struct RowSchema
+{
+	Record defaults;
+	quint8 (*set)(Record& row, Field field, const QJsonValue& value, StringPool& strings);
+};
+
+const RowSchema<UserRecord>& userSchema()
+{
+	static const RowSchema<UserRecord> schema{UserRecord(), &setUserField};
+	return schema;
+}
+
+const RowSchema<TransactionStore::Row>& transactionSchema()
+{
+	static const RowSchema<TransactionStore::Row> schema{TransactionStore::Row(), &setTransactionField};
+	return schema;
+}
+
+/**
+ * @enum RowList
+ * @brief The row lists that may be stored under a "Data" member.
+ */
+enum class RowList
+{
+	None,
+	Users,		 ///< "users", as sent for GetDatabase.
+	Transactions ///< "List", as sent for GetTransactionsHistory.
+};
+
+RowList rowListOf(QAnyStringView key)
+{
+	if (key == QLatin1String("users"))
+	{
+		return RowList::Users;
+	}
+	if (key == QLatin1String("List"))
+	{
+		return RowList::Transactions;
+	}
+	return RowList::None;
+}
+
+/**
+ * @brief Returns the name of the current Name token, unescaping it into storage only when needed.
+ */
+QAnyStringView nameOf(const JsonStreamReader& reader, QString& storage)
+{
+	if (!reader.hasEscapes())
+	{
+		const QByteArrayView raw = reader.rawText();
+		return QUtf8StringView(raw.data(), raw.size());
+	}
+	storage = reader.text();
+	return storage;
+}
+
+template <typename Record, typename Rows>
+bool readJsonRows(JsonStreamReader& reader, const RowSchema<Record>& schema, Rows& rows, quint8& fields)
+{
+	QString	   storage;
+	StringPool strings;
+
+	for (;;)
+	{
+		const JsonStreamReader::Token token = reader.readNext();
+
+		if (token == JsonStreamReader::EndArray)
+		{
+			return true;
+		}
+		if (token != JsonStreamReader::BeginObject)
+		{
+			if (token == JsonStreamReader::Invalid || token == JsonStreamReader::EndOfDocument)
+			{
+				return false;
+			}
+			reader.skipCurrent();
+			continue;
+		}
+
+		Record row = schema.defaults;
+		while (reader.readNext() == JsonStreamReader::Name)
+		{
+			const Field field = fieldOf(nameOf(reader, storage));
+			const auto	value = reader.readNext();
+
+			if (field == Field::Unknown || value == JsonStreamReader::BeginObject || value == JsonStreamReader::BeginArray)
+			{
+				reader.skipCurrent();
+				continue;
+			}
+			fields |= schema.set(row, field, reader.scalarValue(), strings);
+		}
+		if (reader.token() != JsonStreamReader::EndObject)
+		{
+			return false;
+		}
+		rows.append(row);
+	}
+}
+
+bool readJsonData(JsonStreamReader& reader, DecodedResponse& response)
+{
+	QString storage;
+
+	while (reader.readNext() == JsonStreamReader::Name)
+	{
+		const QAnyStringView name = nameOf(reader, storage);
+		const auto			 value = reader.readNext();
+		const RowList		 list = value == JsonStreamReader::BeginArray ? rowListOf(name) : RowList::None;
+
+		if (list == RowList::Users)
+		{
+			if (!readJsonRows(reader, userSchema(), response.users, response.userFields))
+			{
+				return false;
+			}
+		}
+		else if (list == RowList::Transactions)
+		{
+			quint8 fields = 0;
+			if (!readJsonRows(reader, transactionSchema(), response.transactions, fields))
+			{
+				return false;
+			}
+		}
+		else if (value == JsonStreamReader::BeginObject || value == JsonStreamReader::BeginArray)
+		{
+			const QJsonDocument nested = QJsonDocument::fromJson(reader.skipCurrent().toByteArray());
+			response.data.insert(name.toString(),
+								 nested.isArray() ? QJsonValue(nested.array()) : QJsonValue(nested.object()));
+		}
+		else
+		{
+			response.data.insert(name.toString(), reader.scalarValue());
+		}
+	}
+	return reader.token() == JsonStreamReader::EndObject;
+}
+
+DecodedResponse decodeJson(const QByteArray& payload)
+{
+	DecodedResponse	 response;
+	JsonStreamReader reader(payload);
+	bool			 hasCode = false;
+	bool			 hasData = false;
+	bool			 valid = reader.readNext() == JsonStreamReader::BeginObject;
+
+	while (valid && reader.readNext() == JsonStreamReader::Name)
+	{
+		const QByteArrayView name = reader.rawText();
+		const auto			 value = reader.readNext();
+
+		if (name == "Response" && value == JsonStreamReader::Number)
+		{
+			response.code = static_cast<int>(reader.integerValue());
+			hasCode = true;
+		}
+		else if (name == "RequestId" && value == JsonStreamReader::Number)
+		{
+			response.requestId = reader.integerValue();
+		}
+		else if (name == "Data" && value == JsonStreamReader::BeginObject)
+		{
+			valid = readJsonData(reader, response);
+			hasData = true;
+		}
+		else
+		{
+			hasData = hasData || name == "Data";
+			reader.skipCurrent();
+		}
+	}
+
+	if (!valid || reader.hasError())
+	{
+		response = DecodedResponse();
+	}
+	if (!hasCode || !hasData || !valid || reader.hasError())
+	{
+		response.code = ResponseManager::JsonParseError;
+	}
+	return response;
+}
+
+/**
+ * @brief Reads a text string key, skipping keys of any other type.
+ */
+QString readCborKey(QCborStreamReader& reader)
+{
+	QString key;
+
+	if (!reader.isString())
+	{
+		reader.next();
+		return key;
+	}
+
+	auto chunk = reader.readString();
+	while (chunk.status == QCborStreamReader::Ok)
+	{
+		key += chunk.data;
+		chunk = reader.readString();
+	}
+	return key;
+}
+
+template <typename Record, typename Rows>
+void readCborRows(QCborStreamReader& reader, const RowSchema<Record>& schema, Rows& rows, quint8& fields)
+{
+	StringPool strings;
+
+	reader.enterContainer();
+	while (reader.lastError() == QCborError::NoError && reader.hasNext())
+	{
+		if (!reader.isMap())
+		{
+			reader.next();
+			continue;
+		}
+
+		Record row = schema.defaults;
+		reader.enterContainer();
+		while (reader.lastError() == QCborError::NoError && reader.hasNext())
+		{
+			const Field field = fieldOf(readCborKey(reader));
+
+			if (field == Field::Unknown || reader.isContainer())
+			{
+				reader.next();
+				continue;
+			}
+			fields |= schema.set(row, field, QCborValue::fromCbor(reader).toJsonValue(), strings);
+		}
+		reader.leaveContainer();
+		rows.append(row);
+	}
+	reader.leaveContainer();
+}
+
+void readCborData(QCborStreamReader& reader, DecodedResponse& response)
+{
+	reader.enterContainer();
+	while (reader.lastError() == QCborError::NoError && reader.hasNext())
+	{
+		const QString key = readCborKey(reader);
+		const RowList list = reader.isArray() ? rowListOf(key) : RowList::None;
+
+		if (list == RowList::Users)
+		{
+			readCborRows(reader, userSchema(), response.users, response.userFields);
+		}
+		else if (list == RowList::Transactions)
+		{
+			quint8 fields = 0;
+			readCborRows(reader, transactionSchema(), response.transactions, fields);
+		}
+		else
+		{
+			response.data.insert(key, QCborValue::fromCbor(reader).toJsonValue());
+		}
+	}
+	reader.leaveContainer();
+}
+
+DecodedResponse decodeCbor(const QByteArray& payload)
+{
+	DecodedResponse	  response;
+	QCborStreamReader reader(payload);
+	bool			  hasCode = false;
+	bool			  hasData = false;
+
+	if (reader.isMap() && reader.enterContainer())
+	{
+		while (reader.lastError() == QCborError::NoError && reader.hasNext())
+		{
+			const QString key = readCborKey(reader);
+
+			if (key == QLatin1String("Response") && reader.isInteger())
+			{
+				response.code = static_cast<int>(reader.toInteger());
+				hasCode = true;
+				reader.next();
+			}
+			else if (key == QLatin1String("RequestId") && reader.isInteger())
+			{
+				response.requestId = reader.toInteger();
+				reader.next();
+			}
+			else if (key == QLatin1String("Data") && reader.isMap())
+			{
+				readCborData(reader, response);
+				hasData = true;
+			}
+			else
+			{
+				hasData = hasData || key == QLatin1String("Data");
+				reader.next();
+			}
+		}
+		reader.leaveContainer();
+	}
+
+	if (reader.lastError() != QCborError::NoError)
+	{
+		response = DecodedResponse();
+	}
+	if (!hasCode || !hasData || reader.lastError() != QCborError::NoError)
+	{
+		response.code = ResponseManager::JsonParseError;
+	}
+	return response;
+}
+
+template <typename Record, typename Rows>
+void readObjectRows(const QJsonArray& array, const RowSchema<Record>& schema, Rows& rows, quint8& fields)
+{
+	StringPool strings;
+
+	rows.reserve(array.size());
+	for (const QJsonValue& element : array)
+	{
+		const QJsonObject object = element.toObject();
+		Record			  row = schema.defaults;
+
+		for (auto it = object.constBegin(); it != object.constEnd(); ++it)
+		{
+			fields |= schema.set(row, fieldOf(it.key()), it.value(), strings);
+		}
+		rows.append(row);
+	}
+}
+} // namespace
+
+DecodedResponse ResponseDecoder::decode(const QByteArray& payload, MessageCodec::Format format)
+{
+	if (format == MessageCodec::Cbor)
+	{
+		return decodeCbor(payload);
+	}
+	return decodeJson(payload);
+}
+
+DecodedResponse ResponseDecoder::fromObject(const QJsonObject& envelope)
+{
+	DecodedResponse response;
+
+	response.code = envelope.contains("Response") ? envelope.value("Response").toInt() : ResponseManager::JsonParseError;
+	response.requestId = envelope.value("RequestId").toInteger(-1);
+
+	if (!envelope.contains("Data"))
+	{
+		response.code = ResponseManager::JsonParseError;
+	}
+
+	const QJsonObject data = envelope.value("Data").toObject();
+	for (auto it = data.constBegin(); it != data.constEnd(); ++it)
+	{
+		const RowList list = it.value().isArray() ? rowListOf(it.key()) : RowList::None;
+
+		if (list == RowList::Users)
+		{
+			readObjectRows(it.value().toArray(), userSchema(), response.users, response.userFields);
+		}
+		else if (list == RowList::Transactions)
+		{
+			quint8 fields = 0;
+			readObjectRows(it.value().toArray(), transactionSchema(), response.transactions, fields);
+		}
+		else
+		{
+			response.data.insert(it.key(), it.value());
+		}
+	}
+	return response;
+}
@@ -0,0 +1,73 @@
+/**
+ * @file ResponseDecoder.h
+ * @brief Header file for the ResponseDecoder class.
+ *
+ * This file contains the declaration of the decoder turning the raw payload of a reply into the rows
+ * consumed by the widgets, without building an intermediate QJsonDocument or QCborValue tree.
+ */
+
+#ifndef RESPONSEDECODER_H
+#define RESPONSEDECODER_H
+
+#include <QByteArray>
+#include <QJsonObject>
+#include <QList>
+#include <QMetaType>
+#include <QSharedPointer>
+#include <QString>
+#include "MessageCodec.h"
+#include "TransactionStore.h"
+#include "UserRecord.h"
+
+/**
+ * @struct DecodedResponse
+ * @brief A reply envelope with its row lists already extracted.
+ */
+struct DecodedResponse
+{
+	int							  code = 0;		  ///< The "Response" code, JsonParseError if the envelope is invalid.
+	qint64						  requestId = -1; ///< The "RequestId" of the envelope, -1 if absent.
+	QJsonObject					  data;			  ///< Members of "Data", except the row lists below.
+	QList<UserRecord>			  users;		  ///< Rows of "Data.users", as sent for GetDatabase.
+	TransactionStore			  transactions;	  ///< Rows of "Data.List", as sent for GetTransactionsHistory.
+	quint8						  userFields = 0; ///< UserRecord::Field flags of the fields found in at least one user.
+};
+
+/**
+ * @brief Shared handle to an immutable decoded response, as handed from the decode thread to the GUI thread.
+ */
+using ResponsePtr = QSharedPointer<const DecodedResponse>;
+
+Q_DECLARE_METATYPE(ResponsePtr)
+
+/**
+ * @class ResponseDecoder
+ * @brief Decodes reply envelopes in a single pass.
+ *
+ * JSON payloads are read with @ref JsonStreamReader and CBOR payloads with QCborStreamReader. Row
+ * fields are converted as they are read and written straight into the destination rows, unknown
+ * fields are skipped without being converted. Fields left out of a reply keep their default value,
+ * and the user fields found are reported so that a projected reply can be told apart.
+ */
+class ResponseDecoder
+{
+public:
+	/**
+	 * @brief Decodes a raw payload.
+	 *
+	 * @param payload The encoded envelope.
+	 * @param format The encoding of the payload.
+	 * @return The decoded envelope.
+	 */
+	static DecodedResponse decode(const QByteArray& payload, MessageCodec::Format format);
+
+	/**
+	 * @brief Extracts the rows of an envelope already decoded as a QJsonObject.
+	 *
+	 * @param envelope The envelope, as built for connection events or in tests.
+	 * @return The decoded envelope.
+	 */
+	static DecodedResponse fromObject(const QJsonObject& envelope);
+};
+
+#endif // RESPONSEDECODER_H
@@ -0,0 +1,47 @@
+/**
+ * @file ResponseDecoderWorker.cpp
+ * @brief Implementation file for the ResponseDecoderWorker class.
+ */
+#include "ResponseDecoderWorker.h"
+#include "ResponseManager.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+
+ResponseDecoderWorker::ResponseDecoderWorker(QObject* parent) : QObject(parent)
+{
+}
+
+void ResponseDecoderWorker::decode(MessagePtr message)
+{
+	if (!message->isEncoded())
+	{
+		emit responseDecoded(ResponsePtr::create(ResponseDecoder::fromObject(message->envelope())));
+		return;
+	}
+
+	// "Not modified" replies carry nothing but their RequestId, so only the envelope is read
+	MessageCodec::Envelope envelope;
+
+	if (MessageCodec::forFormat(message->format()).peek(message->payload(), envelope)
+		&& envelope.code == ResponseManager::NotModified)
+	{
+		DecodedResponse response;
+		response.code = envelope.code;
+		response.requestId = envelope.hasRequestId ? envelope.requestId : -1;
+
+		emit responseDecoded(ResponsePtr::create(std::move(response)));
+		return;
+	}
+
+	QElapsedTimer timer;
+	timer.start();
+
+	ResponsePtr response = ResponsePtr::create(ResponseDecoder::decode(message->payload(), message->format()));
+
+	qDebug().nospace() << "---> Response " << response->code << " received from server (" << message->payload().size()
+					   << " bytes, " << response->users.size() + response->transactions.size() << " rows, decoded in "
+					   << timer.nsecsElapsed() / 1000 << " us)";
+
+	emit responseDecoded(response);
+}
@@ -0,0 +1,55 @@
+/**
+ * @file ResponseDecoderWorker.h
+ * @brief Header file for the ResponseDecoderWorker class.
+ *
+ * This file contains the declaration of the worker that decodes server replies on its own thread,
+ * between the network thread and the GUI thread.
+ */
+
+#ifndef RESPONSEDECODERWORKER_H
+#define RESPONSEDECODERWORKER_H
+
+#include <QObject>
+#include "NetworkMessage.h"
+#include "ResponseDecoder.h"
+
+/**
+ * @class ResponseDecoderWorker
+ * @brief Decodes replies into @ref DecodedResponse objects.
+ *
+ * The worker is moved to a dedicated thread. It receives encoded replies from the ClientHandler and
+ * hands the decoded responses to the ResponseManager, so that the GUI thread only applies results.
+ * Replies are decoded one at a time, in the order they were received.
+ */
+class ResponseDecoderWorker : public QObject
+{
+	Q_OBJECT
+public:
+	/**
+	 * @brief Constructor for ResponseDecoderWorker.
+	 *
+	 * @param parent The parent QObject, default is nullptr.
+	 */
+	explicit ResponseDecoderWorker(QObject* parent = nullptr);
+
+public slots:
+	/**
+	 * @brief Decodes a reply.
+	 *
+	 * Envelopes built locally, such as connection events, go through the same path so that they keep
+	 * their place among the replies.
+	 *
+	 * @param message The encoded reply or local envelope.
+	 */
+	void decode(MessagePtr message);
+
+signals:
+	/**
+	 * @brief Signal emitted when a reply has been decoded.
+	 *
+	 * @param response The decoded reply.
+	 */
+	void responseDecoded(ResponsePtr response);
+};
+
+#endif // RESPONSEDECODERWORKER_H
@@ -27,30 +27,18 @@ ResponseManager::ResponseManager(QObject* parent) : QObject(parent)
 
 void ResponseManager::handleResponse(QJsonObject Data)
 {
-	int			responseCode = 0; // make sure that there is no response code = 0
-	QJsonObject dataObject;
-
-	qDebug().noquote() << "---> Response received from server:\n"
-					   << QJsonDocument(Data).toJson(QJsonDocument::Indented);
+	handleDecodedResponse(ResponseDecoder::fromObject(Data));
+}
 
-	// get the response code
-	if (Data.contains("Response"))
-	{
-		responseCode = Data.value("Response").toInt();
-	}
-	else
-	{
-		responseCode = JsonParseError;
-	}
+void ResponseManager::handleDecodedResponse(const DecodedResponse& response)
+{
+	const int		   responseCode = response.code;
+	const QJsonObject& dataObject = response.data;
 
-	// check for the response data object
-	if (Data.contains("Data"))
-	{
-		dataObject = Data.value("Data").toObject();
-	}
-	else
+	// Any reply may tell that the token was refused, the request itself failed as well
+	if (dataObject.value("session_expired").toBool())
 	{
-		responseCode = JsonParseError;
+		emit SessionExpired();
 	}
 
 	switch (responseCode)
@@ -72,7 +60,21 @@ void ResponseManager::handleResponse(QJsonObject Data)
 				QString first_name = dataObject.value("first_name").toString();
 				QString role = dataObject.value("role").toString();
 
+				if (dataObject.contains("token"))
+				{
+					emit SessionOpened(dataObject.value("token").toString());
+				}
 				emit SuccessfullRequest("Login Successfull : " + role);
+
+				// Servers answering the combined login echo "init" along with the UserInit fields
+				if (dataObject.value("init").toBool())
+				{
+					handleUserInit(dataObject);
+				}
+				else
+				{
+					emit LoginAccepted();
+				}
 			}
 			else
 			{
@@ -87,7 +89,7 @@ void ResponseManager::handleResponse(QJsonObject Data)
 			if (getResponseStatus(dataObject))
 			{
 				QString balance = QString::number(dataObject.value("balance").toDouble(), 'f', 2);
-				emit	BalanceFetched(balance);
+				emit	BalanceFetched(balance, dataObject.value("version").toVariant());
 			}
 			else
 			{
@@ -98,27 +100,15 @@ void ResponseManager::handleResponse(QJsonObject Data)
 		case GetTransactionsHistory:
 			if (getResponseStatus(dataObject))
 			{
-				// extract the transactions list
-				QList<QMap<QString, QString>> transactions;
-				QJsonArray					  transactionsArray = dataObject.value("List").toArray();
+				TransactionPage page;
+				page.requestId = response.requestId;
+				page.rows = response.transactions;
+				page.nextCursor = dataObject.value("next_cursor").toVariant();
+				page.hasMore = dataObject.value("has_more").toBool();
+				page.isDelta = dataObject.contains("since");
+				page.version = dataObject.value("version").toVariant();
 
-				for (int i = 0; i < transactionsArray.size(); i++)
-				{
-					QMap<QString, QString> transaction;
-					QJsonObject			   transactionObject = transactionsArray.at(i).toObject();
-
-					transaction.insert("from_account_number",
-									   QString::number(transactionObject.value("from_account_number").toInt()));
-					transaction.insert("to_account_number",
-									   QString::number(transactionObject.value("to_account_number").toInt()));
-					transaction.insert("transaction_amount",
-									   QString::number(transactionObject.value("amount").toDouble(), 'f', 2));
-					transaction.insert("created_at", transactionObject.value("created_at").toString());
-
-					transactions.append(transaction);
-				}
-
-				emit TransactionsFetched(transactions);
+				emit TransactionsFetched(page);
 			}
 			else
 			{
@@ -126,6 +116,10 @@ void ResponseManager::handleResponse(QJsonObject Data)
 			}
 			break;
 
+		case NotModified:
+			emit ResultUnchanged(response.requestId);
+			break;
+
 		case TransferAmount: // not emplemented
 
 			// handle the transfer amount response
@@ -134,26 +128,18 @@ void ResponseManager::handleResponse(QJsonObject Data)
 		case GetDatabase:
 			if (getResponseStatus(dataObject))
 			{
-				// extract the database content
-				QList<QMap<QString, QString>> databaseContent;
-				QJsonArray					  databaseArray = dataObject.value("users").toArray();
-
-				for (int i = 0; i < databaseArray.size(); i++)
+				UserPage page;
+				page.requestId = response.requestId;
+				page.offset = dataObject.value("offset").toInteger(0);
+				page.total = dataObject.contains("total") ? dataObject.value("total").toInteger(-1) : -1;
+				page.users = response.users;
+				if (!response.users.isEmpty())
 				{
-					QMap<QString, QString> user;
-					QJsonObject			   userObject = databaseArray.at(i).toObject();
-
-					user.insert("first_name", userObject.value("first_name").toString());
-					user.insert("last_name", userObject.value("last_name").toString());
-					user.insert("email", userObject.value("email").toString());
-					user.insert("role", userObject.value("role").toString());
-					user.insert("account_number", QString::number(userObject.value("account_number").toInt()));
-					user.insert("balance", QString::number(userObject.value("balance").toDouble(), 'f', 2));
-
-					databaseContent.append(user);
+					page.fields = response.userFields;
 				}
+				page.version = dataObject.value("version").toVariant();
 
-				emit DatabaseFetched(databaseContent);
+				emit DatabaseFetched(page);
 			}
 			else
 			{
@@ -162,27 +148,38 @@ void ResponseManager::handleResponse(QJsonObject Data)
 
 			break;
 
-		case UserInit:
+		case SearchUsers:
 			if (getResponseStatus(dataObject))
 			{
-				// get user name and role
-				QString first_name = dataObject.value("first_name").toString();
-				QString role = dataObject.value("role").toString();
-				QString email = dataObject.value("email").toString();
-
-				if (role == "admin")
+				UserPage page;
+				page.requestId = response.requestId;
+				page.users = response.users;
+				page.total = dataObject.value("total").toInteger(response.users.size());
+				if (!response.users.isEmpty())
 				{
-					emit adminLoginSuccess(email, first_name);
+					page.fields = response.userFields;
 				}
-				else if (role == "user")
-				{
-					// get account number, balance and transactions
-					QString account_number = QString::number(dataObject.value("account_number").toInt());
 
-					QString balance = QString::number(dataObject.value("current_balance").toDouble(), 'f', 2);
+				emit UsersFound(page);
+			}
+			else
+			{
+				emit FailedRequest(getResponseMessage(dataObject));
+			}
+			break;
 
-					emit userloginSuccess(email, first_name, account_number, balance);
-				}
+		case Subscribe:
+			emit SubscriptionChanged(response.requestId, getResponseStatus(dataObject));
+			break;
+
+		case Event:
+			handleEvent(response);
+			break;
+
+		case UserInit:
+			if (getResponseStatus(dataObject))
+			{
+				handleUserInit(dataObject);
 			}
 			else
 			{
@@ -212,4 +209,62 @@ void ResponseManager::handleResponse(QJsonObject Data)
 
 			break;
 	}
-}
\ No newline at end of file
+}
+
+void ResponseManager::handleUserInit(const QJsonObject& dataObject)
+{
+	// get user name and role
+	QString first_name = dataObject.value("first_name").toString();
+	QString role = dataObject.value("role").toString();
+	QString email = dataObject.value("email").toString();
+
+	if (role == "admin")
+	{
+		emit adminLoginSuccess(email, first_name);
+	}
+	else if (role == "user")
+	{
+		// get account number, balance and transactions
+		QString account_number = QString::number(dataObject.value("account_number").toInt());
+
+		QString balance = QString::number(dataObject.value("current_balance").toDouble(), 'f', 2);
+
+		emit userloginSuccess(email, first_name, account_number, balance);
+	}
+}
+
+void ResponseManager::handleEvent(const DecodedResponse& response)
+{
+	const QJsonObject& dataObject = response.data;
+	const QString	   event = dataObject.value("event").toString();
+
+	if (event == "balance")
+	{
+		QString balance = QString::number(dataObject.value("balance").toDouble(), 'f', 2);
+		emit	BalanceChanged(balance, dataObject.value("version").toVariant());
+	}
+	else if (event == "transactions")
+	{
+		TransactionPage page;
+		page.rows = response.transactions;
+		page.version = dataObject.value("version").toVariant();
+
+		emit TransactionsPushed(page);
+	}
+	else if (event == "user_created" || event == "user_updated" || event == "user_deleted" || event == "balance_changed")
+	{
+		UserChange change;
+		change.kind = event == "user_created" ? UserChange::Created
+					  : event == "user_deleted" ? UserChange::Deleted
+												: UserChange::Updated;
+		change.users = response.users;
+		change.fields = response.userFields;
+
+		emit UsersChanged(change);
+	}
+	else
+	{
+		// Events of topics added later are ignored by older clients
+		qDebug() << "Unknown event: " << event;
+	}
+}
@@ -5,6 +5,73 @@
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
+#include <QVariant>
+#include "ResponseDecoder.h"
+
+/**
+ * @struct TransactionPage
+ * @brief One page of a GetTransactionsHistory reply.
+ *
+ * Servers that do not page the history send everything at once, with hasMore false. A delta reply
+ * holds the transactions from the "since" of the request on, and hasMore tells that some are missing.
+ * Servers supporting conditional fetches tag the reply with a "version".
+ */
+struct TransactionPage
+{
+	qint64						  requestId = -1;  ///< The "RequestId" of the reply, -1 if absent.
+	TransactionStore			  rows;			   ///< The transactions, newest first.
+	QVariant					  nextCursor;	   ///< Opaque "next_cursor" to request the following, older page.
+	bool						  hasMore = false; ///< Whether older transactions are available.
+	bool						  isDelta = false; ///< Whether only the transactions since the request's "since" were sent.
+	QVariant					  version;		   ///< Opaque "version" of the history, sent back as "if_version" on refresh.
+};
+
+Q_DECLARE_METATYPE(TransactionPage)
+
+/**
+ * @struct UserPage
+ * @brief One page of a GetDatabase reply.
+ *
+ * Servers that do not page the database send every user at once, without "total". A reply to a
+ * request naming "fields" may only carry those fields.
+ */
+struct UserPage
+{
+	qint64			  requestId = -1; ///< The "RequestId" of the reply, -1 if absent.
+	qint64			  offset = 0;	  ///< Position of the first user of the page.
+	qint64			  total = -1;	  ///< Number of users in the database, -1 if the reply is not paged.
+	QList<UserRecord> users;		  ///< The users of the page.
+	QVariant		  version;		  ///< Opaque "version" of the page, sent back as "if_version" on refresh.
+	quint8			  fields = UserRecord::AllFields; ///< UserRecord::Field flags of the fields sent.
+};
+
+Q_DECLARE_METATYPE(UserPage)
+
+/**
+ * @struct UserChange
+ * @brief Users created, updated or deleted, as pushed on the "users" topic.
+ *
+ * Updates may only carry some fields, such as the account number and balance of a balance change.
+ */
+struct UserChange
+{
+	/**
+	 * @enum Kind
+	 * @brief What happened to the users.
+	 */
+	enum Kind
+	{
+		Created, ///< The users were added.
+		Updated, ///< The fields sent of the users changed.
+		Deleted	 ///< The users were removed, only their identifying fields matter.
+	};
+
+	Kind			  kind = Updated;				  ///< What happened to the users.
+	QList<UserRecord> users;						  ///< The users, with the fields sent.
+	quint8			  fields = UserRecord::AllFields; ///< UserRecord::Field flags of the fields sent.
+};
+
+Q_DECLARE_METATYPE(UserChange)
 
 /**
  * @class ResponseManager
@@ -13,6 +80,12 @@
  * The ResponseManager class processes server responses and emits signals based on the response type.
  * It handles various response types defined in the AvailableRequests enum and provides feedback
  * through signals to update the application state accordingly.
+ *
+ * Events pushed by the server name their kind in "event":
+ * - "balance": the "balance" of the subscribed account changed.
+ * - "transactions": transactions listed under "List" were made on the subscribed account.
+ * - "user_created", "user_updated", "user_deleted" and "balance_changed": the users listed under
+ *   "users" changed, a balance change only sending their "account_number" and "balance".
  */
 class ResponseManager : public QObject
 {
@@ -40,8 +113,13 @@ public: // for testing
 		UserInit,			 ///< Response to initialize user
 		UpdateEmail,		 ///< Response to update user email
 		UpdatePassword,		 ///< Response to update user password
+		Handshake,			 ///< Response to the codec negotiation (consumed by the ClientHandler)
+		SearchUsers,		 ///< Response to a user search
+		Subscribe,			 ///< Response to a subscription
 		JsonParseError = -1, ///< Indicates a JSON parse error
-		Connection = -2		 ///< Indicates a connection response
+		Connection = -2,	 ///< Indicates a connection response
+		NotModified = -3,	 ///< The result named by the "if_version" of the request did not change
+		Event = -4			 ///< Event pushed by the server on a subscribed topic, without RequestId
 	};
 
 	/**
@@ -60,6 +138,20 @@ public: // for testing
 	 */
 	QString getResponseMessage(QJsonObject Data);
 
+	/**
+	 * @brief Emits the login signal matching the role of a UserInit payload.
+	 *
+	 * @param Data The QJsonObject holding the role, names, account number and balance.
+	 */
+	void handleUserInit(const QJsonObject& Data);
+
+	/**
+	 * @brief Emits the signal matching an event pushed by the server.
+	 *
+	 * @param response The decoded event.
+	 */
+	void handleEvent(const DecodedResponse& response);
+
 signals:
 
 	/**
@@ -72,6 +164,12 @@ signals:
 	 */
 	void userloginSuccess(QString email, QString first_name, QString account_number, QString balance);
 
+	/**
+	 * @brief Signal emitted when the credentials are accepted by a server that did not send the
+	 * UserInit payload along, which must then be requested.
+	 */
+	void LoginAccepted();
+
 	/**
 	 * @brief Signal emitted when an admin login is successful.
 	 *
@@ -80,6 +178,18 @@ signals:
 	 */
 	void adminLoginSuccess(QString email, QString first_name);
 
+	/**
+	 * @brief Signal emitted when the server opens a session at login.
+	 *
+	 * @param token The session token, to be sent with the following requests.
+	 */
+	void SessionOpened(QString token);
+
+	/**
+	 * @brief Signal emitted when the server no longer accepts the session token.
+	 */
+	void SessionExpired();
+
 	/**
 	 * @brief Signal emitted for connection response.
 	 *
@@ -90,23 +200,70 @@ signals:
 	/**
 	 * @brief Signal emitted when transactions are fetched.
 	 *
-	 * @param transactions List of transactions.
+	 * @param page The page of transactions received.
 	 */
-	void TransactionsFetched(const QList<QMap<QString, QString>>& transactions);
+	void TransactionsFetched(const TransactionPage& page);
 
 	/**
 	 * @brief Signal emitted when the database content is fetched.
 	 *
-	 * @param databaseContent List of database content.
+	 * @param page The fetched users, a whole snapshot when the reply is not paged.
+	 */
+	void DatabaseFetched(const UserPage& page);
+
+	/**
+	 * @brief Signal emitted when the users matching a search are received.
+	 *
+	 * @param page The matching users, total being the number of matches, which may be more than sent.
+	 */
+	void UsersFound(const UserPage& page);
+
+	/**
+	 * @brief Signal emitted when the server answers a subscription.
+	 *
+	 * @param requestId The RequestId of the Subscribe request.
+	 * @param active Whether events will be pushed, false when the server refused or does not support it.
+	 */
+	void SubscriptionChanged(qint64 requestId, bool active);
+
+	/**
+	 * @brief Signal emitted when the server pushes a new balance.
+	 *
+	 * @param balance User's balance.
+	 * @param version Opaque "version" of the balance, null if the server does not send one.
+	 */
+	void BalanceChanged(QString balance, QVariant version);
+
+	/**
+	 * @brief Signal emitted when the server pushes new transactions.
+	 *
+	 * @param page The new transactions, newest first, with no RequestId.
 	 */
-	void DatabaseFetched(const QList<QMap<QString, QString>>& databaseContent);
+	void TransactionsPushed(const TransactionPage& page);
+
+	/**
+	 * @brief Signal emitted when the server pushes a change to the users of the bank.
+	 *
+	 * @param change The users changed.
+	 */
+	void UsersChanged(const UserChange& change);
 
 	/**
 	 * @brief Signal emitted when the balance is fetched.
 	 *
 	 * @param balance User's balance.
+	 * @param version Opaque "version" of the balance, null if the server does not send one.
 	 */
-	void BalanceFetched(QString balance);
+	void BalanceFetched(QString balance, QVariant version);
+
+	/**
+	 * @brief Signal emitted when the server tells that a cached result is still current.
+	 *
+	 * The reply carries no data, the request is identified by its RequestId only.
+	 *
+	 * @param requestId The RequestId of the conditional request.
+	 */
+	void ResultUnchanged(qint64 requestId);
 
 	/**
 	 * @brief Signal emitted for a successful request.
@@ -137,6 +294,16 @@ public:
 	 * @return void
 	 */
 	void handleResponse(QJsonObject Data);
+
+	/**
+	 * @brief Emits the signals matching a decoded response.
+	 *
+	 * This is the only work done on the GUI thread for a reply, the rows are already built by the
+	 * @ref ResponseDecoderWorker.
+	 *
+	 * @param response The decoded envelope.
+	 */
+	void handleDecodedResponse(const DecodedResponse& response);
 };
 
 #endif // RESPONSEMANAGER_H
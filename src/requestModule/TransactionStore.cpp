@@ -0,0 +1,282 @@
+/**
+ * @file TransactionStore.cpp
+ * @brief Implementation file for the TransactionStore class.
+ */
+#include "TransactionStore.h"
+
+#include <QDateTime>
+#include <QTimeZone>
+#include <cmath>
+
+namespace
+{
+/**
+ * @brief Reads a fixed number of digits.
+ *
+ * @return The value, or -1 if a character is not a digit.
+ */
+int readDigits(QStringView text, qsizetype pos, qsizetype count)
+{
+	if (pos + count > text.size())
+	{
+		return -1;
+	}
+
+	int value = 0;
+	for (qsizetype i = pos; i < pos + count; ++i)
+	{
+		const char16_t c = text.at(i).unicode();
+		if (c < u'0' || c > u'9')
+		{
+			return -1;
+		}
+		value = value * 10 + (c - u'0');
+	}
+	return value;
+}
+
+/**
+ * @brief Returns the number of days between 1970-01-01 and a civil date (proleptic Gregorian).
+ */
+qint64 daysFromCivil(qint64 year, int month, int day)
+{
+	year -= month <= 2 ? 1 : 0;
+	const qint64 era = (year >= 0 ? year : year - 399) / 400;
+	const qint64 yearOfEra = year - era * 400;
+	const qint64 dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+	const qint64 dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+	return era * 146097 + dayOfEra - 719468;
+}
+/**
+ * @brief Parses "yyyy-MM-dd[ T]HH:mm:ss", optionally followed by fractions and by 'Z' or an offset
+ * written "+HH", "+HHMM" or "+HH:MM".
+ *
+ * @param msecs Set to the date in ms since the epoch when the text has this exact form.
+ * @return false if the text has any other form.
+ */
+bool parseIsoTimestamp(QStringView text, qint64& msecs)
+{
+	const int year = readDigits(text, 0, 4);
+	const int month = readDigits(text, 5, 2);
+	const int day = readDigits(text, 8, 2);
+	const int hour = readDigits(text, 11, 2);
+	const int minute = readDigits(text, 14, 2);
+	const int second = readDigits(text, 17, 2);
+
+	if (year < 0 || month < 1 || month > 12 || day < 1 || day > 31 || hour < 0 || hour >= 24 || minute < 0 ||
+		minute >= 60 || second < 0 || second >= 61 || text.at(4) != u'-' || text.at(7) != u'-' ||
+		(text.at(10) != u' ' && text.at(10) != u'T') || text.at(13) != u':' || text.at(16) != u':')
+	{
+		return false;
+	}
+
+	qsizetype pos = 19;
+	qint64	  fraction = 0;
+
+	if (pos < text.size() && text.at(pos) == u'.')
+	{
+		int scale = 100;
+		for (++pos; pos < text.size() && text.at(pos).isDigit(); ++pos)
+		{
+			fraction += (text.at(pos).unicode() - u'0') * scale;
+			scale /= 10;
+		}
+	}
+
+	qint64 offsetSecs = 0;
+	if (pos < text.size() && (text.at(pos) == u'+' || text.at(pos) == u'-'))
+	{
+		const qint64	sign = text.at(pos) == u'-' ? -1 : 1;
+		const int		offsetHours = readDigits(text, pos + 1, 2);
+		int				offsetMinutes = 0;
+		const qsizetype rest = text.size() - (pos + 3);
+
+		if (rest == 3 && text.at(pos + 3) == u':')
+		{
+			offsetMinutes = readDigits(text, pos + 4, 2);
+		}
+		else if (rest == 2)
+		{
+			offsetMinutes = readDigits(text, pos + 3, 2);
+		}
+		else if (rest != 0)
+		{
+			return false;
+		}
+		if (offsetHours < 0 || offsetMinutes < 0)
+		{
+			return false;
+		}
+		offsetSecs = sign * (offsetHours * 3600 + offsetMinutes * 60);
+	}
+	else if (pos < text.size() && !(text.at(pos) == u'Z' && pos + 1 == text.size()))
+	{
+		return false;
+	}
+
+	const qint64 secs = daysFromCivil(year, month, day) * 86400 + hour * 3600 + minute * 60 + second - offsetSecs;
+	msecs = secs * 1000 + fraction;
+	return true;
+}
+} // namespace
+
+qsizetype TransactionStore::size() const
+{
+	return fromAccounts_.size();
+}
+
+bool TransactionStore::isEmpty() const
+{
+	return fromAccounts_.isEmpty();
+}
+
+void TransactionStore::reserve(qsizetype rows)
+{
+	fromAccounts_.reserve(rows);
+	toAccounts_.reserve(rows);
+	amountsCents_.reserve(rows);
+	createdAts_.reserve(rows);
+}
+
+void TransactionStore::clear()
+{
+	fromAccounts_.clear();
+	toAccounts_.clear();
+	amountsCents_.clear();
+	createdAts_.clear();
+}
+
+void TransactionStore::append(const Row& row)
+{
+	fromAccounts_.append(row.fromAccount);
+	toAccounts_.append(row.toAccount);
+	amountsCents_.append(row.amountCents);
+	createdAts_.append(row.createdAt);
+}
+
+void TransactionStore::append(const TransactionStore& other)
+{
+	fromAccounts_.append(other.fromAccounts_);
+	toAccounts_.append(other.toAccounts_);
+	amountsCents_.append(other.amountsCents_);
+	createdAts_.append(other.createdAts_);
+}
+
+TransactionStore::Row TransactionStore::at(qsizetype row) const
+{
+	Row result;
+	result.fromAccount = fromAccounts_.at(row);
+	result.toAccount = toAccounts_.at(row);
+	result.amountCents = amountsCents_.at(row);
+	result.createdAt = createdAts_.at(row);
+	return result;
+}
+
+TransactionStore TransactionStore::first(qsizetype rows) const
+{
+	TransactionStore result;
+	result.fromAccounts_ = fromAccounts_.first(rows);
+	result.toAccounts_ = toAccounts_.first(rows);
+	result.amountsCents_ = amountsCents_.first(rows);
+	result.createdAts_ = createdAts_.first(rows);
+	return result;
+}
+
+qsizetype TransactionStore::indexOf(const Row& row) const
+{
+	// Scan the most selective column first, the others are only read on a match
+	for (qsizetype i = createdAts_.indexOf(row.createdAt); i >= 0; i = createdAts_.indexOf(row.createdAt, i + 1))
+	{
+		if (at(i) == row)
+		{
+			return i;
+		}
+	}
+	return -1;
+}
+
+const QList<qint64>& TransactionStore::fromAccounts() const
+{
+	return fromAccounts_;
+}
+
+const QList<qint64>& TransactionStore::toAccounts() const
+{
+	return toAccounts_;
+}
+
+const QList<qint64>& TransactionStore::amountsCents() const
+{
+	return amountsCents_;
+}
+
+const QList<qint64>& TransactionStore::createdAts() const
+{
+	return createdAts_;
+}
+
+bool TransactionStore::operator==(const TransactionStore& other) const
+{
+	return fromAccounts_ == other.fromAccounts_ && toAccounts_ == other.toAccounts_ &&
+		   amountsCents_ == other.amountsCents_ && createdAts_ == other.createdAts_;
+}
+
+qint64 TransactionStore::toCents(double amount)
+{
+	return static_cast<qint64>(std::llround(amount * 100.0));
+}
+
+QString TransactionStore::formatAmount(qint64 cents)
+{
+	const qint64 magnitude = cents < 0 ? -cents : cents;
+	QString		 text = QString::number(magnitude / 100) + '.' + QString::number(magnitude % 100).rightJustified(2, '0');
+
+	return cents < 0 ? '-' + text : text;
+}
+
+qint64 TransactionStore::parseTimestamp(QStringView text)
+{
+	text = text.trimmed();
+
+	qint64 msecs = 0;
+	if (parseIsoTimestamp(text, msecs))
+	{
+		return msecs;
+	}
+
+	// Anything the fast path does not know is left to QDateTime, which only takes 'T' as separator
+	QString isoText = text.toString();
+	if (isoText.size() > 10 && isoText.at(10) == u' ')
+	{
+		isoText[10] = u'T';
+	}
+
+	QDateTime dateTime = QDateTime::fromString(isoText, Qt::ISODateWithMs);
+	if (!dateTime.isValid())
+	{
+		return InvalidTimestamp;
+	}
+	if (dateTime.timeSpec() == Qt::LocalTime)
+	{
+		dateTime.setTimeZone(QTimeZone::utc());
+	}
+	return dateTime.toMSecsSinceEpoch();
+}
+
+QString TransactionStore::formatTimestamp(qint64 msecs)
+{
+	if (msecs == InvalidTimestamp)
+	{
+		return QString();
+	}
+	return QDateTime::fromMSecsSinceEpoch(msecs, QTimeZone::utc()).toString("yyyy-MM-dd HH:mm:ss");
+}
+
+QString TransactionStore::formatIsoTimestamp(qint64 msecs)
+{
+	if (msecs == InvalidTimestamp)
+	{
+		return QString();
+	}
+	return QDateTime::fromMSecsSinceEpoch(msecs, QTimeZone::utc()).toString(Qt::ISODateWithMs);
+}
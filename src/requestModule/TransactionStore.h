@@ -0,0 +1,143 @@
+/**
+ * @file TransactionStore.h
+ * @brief Header file for the TransactionStore class.
+ *
+ * This file contains the declaration of the columnar container holding decoded transactions.
+ */
+
+#ifndef TRANSACTIONSTORE_H
+#define TRANSACTIONSTORE_H
+
+#include <QList>
+#include <QString>
+#include <QStringView>
+#include <QtGlobal>
+#include <limits>
+
+/**
+ * @class TransactionStore
+ * @brief Transactions stored as one array per column.
+ *
+ * Account numbers, amounts and dates are kept as 64-bit integers: amounts in cents and dates in
+ * milliseconds since the Unix epoch (UTC). Text is only produced by formatAmount() and
+ * formatTimestamp() when a value is displayed, so filters, sorts and exports work on plain arrays.
+ *
+ * The columns are implicitly shared, copying a store is cheap until one of the copies is modified.
+ */
+class TransactionStore
+{
+public:
+	static constexpr qint64 InvalidTimestamp = std::numeric_limits<qint64>::min(); ///< Date that could not be parsed.
+
+	/**
+	 * @struct Row
+	 * @brief The values of one transaction, used to add and compare rows.
+	 */
+	struct Row
+	{
+		qint64 fromAccount = 0;				   ///< Account the money was sent from.
+		qint64 toAccount = 0;				   ///< Account the money was sent to.
+		qint64 amountCents = 0;				   ///< Transferred amount, in cents.
+		qint64 createdAt = InvalidTimestamp; ///< Date of the transaction, in ms since the epoch.
+
+		bool operator==(const Row& other) const
+		{
+			return fromAccount == other.fromAccount && toAccount == other.toAccount &&
+				   amountCents == other.amountCents && createdAt == other.createdAt;
+		}
+	};
+
+	/**
+	 * @brief Returns the number of transactions.
+	 */
+	qsizetype size() const;
+
+	/**
+	 * @brief Tells whether the store is empty.
+	 */
+	bool isEmpty() const;
+
+	/**
+	 * @brief Reserves room for a number of transactions.
+	 */
+	void reserve(qsizetype rows);
+
+	/**
+	 * @brief Removes every transaction.
+	 */
+	void clear();
+
+	/**
+	 * @brief Appends one transaction.
+	 */
+	void append(const Row& row);
+
+	/**
+	 * @brief Appends every transaction of another store.
+	 */
+	void append(const TransactionStore& other);
+
+	/**
+	 * @brief Returns the transaction at a given position, which must be valid.
+	 */
+	Row at(qsizetype row) const;
+
+	/**
+	 * @brief Returns a store holding the first rows of this one.
+	 *
+	 * @param rows Number of rows to keep, at most size().
+	 */
+	TransactionStore first(qsizetype rows) const;
+
+	/**
+	 * @brief Returns the position of the first transaction equal to row, or -1.
+	 */
+	qsizetype indexOf(const Row& row) const;
+
+	const QList<qint64>& fromAccounts() const; ///< Column of the sending accounts.
+	const QList<qint64>& toAccounts() const;   ///< Column of the receiving accounts.
+	const QList<qint64>& amountsCents() const; ///< Column of the amounts, in cents.
+	const QList<qint64>& createdAts() const;   ///< Column of the dates, in ms since the epoch.
+
+	bool operator==(const TransactionStore& other) const;
+
+	/**
+	 * @brief Converts an amount to cents, rounding to the nearest cent.
+	 */
+	static qint64 toCents(double amount);
+
+	/**
+	 * @brief Formats an amount in cents with two decimals, e.g. "-12.50".
+	 */
+	static QString formatAmount(qint64 cents);
+
+	/**
+	 * @brief Parses a date such as "2024-06-01 10:00:00" or "2024-06-01T10:00:00.250Z".
+	 *
+	 * Dates without an offset are taken as UTC, so that formatTimestamp() gives the text back. Offsets
+	 * may be written "+HH", "+HHMM" or "+HH:MM", and other ISO 8601 forms go through QDateTime.
+	 *
+	 * @return The date in ms since the epoch, or InvalidTimestamp.
+	 */
+	static qint64 parseTimestamp(QStringView text);
+
+	/**
+	 * @brief Formats a date as "yyyy-MM-dd HH:mm:ss", in UTC.
+	 */
+	static QString formatTimestamp(qint64 msecs);
+
+	/**
+	 * @brief Formats a date as ISO 8601 in UTC with milliseconds, e.g. "2024-06-01T10:00:00.250Z".
+	 *
+	 * Used for dates sent to the server, which must not depend on its time zone.
+	 */
+	static QString formatIsoTimestamp(qint64 msecs);
+
+private:
+	QList<qint64> fromAccounts_; ///< Sending accounts.
+	QList<qint64> toAccounts_;	 ///< Receiving accounts.
+	QList<qint64> amountsCents_; ///< Amounts in cents.
+	QList<qint64> createdAts_;	 ///< Dates in ms since the epoch.
+};
+
+#endif // TRANSACTIONSTORE_H
@@ -0,0 +1,115 @@
+/**
+ * @file UserRecord.cpp
+ * @brief Implementation file for the UserRecord structure.
+ */
+#include "UserRecord.h"
+
+UserRecord::Role UserRecord::roleFromString(QStringView text)
+{
+	if (text == u"user")
+	{
+		return User;
+	}
+	if (text == u"admin")
+	{
+		return Admin;
+	}
+	return UnknownRole;
+}
+
+QString UserRecord::roleName(Role role)
+{
+	switch (role)
+	{
+		case User:
+			return QStringLiteral("user");
+		case Admin:
+			return QStringLiteral("admin");
+		default:
+			return QString();
+	}
+}
+
+QStringList UserRecord::fieldNames(quint8 fields)
+{
+	static const char* const names[] = {"account_number", "first_name", "last_name", "email", "role", "balance"};
+
+	QStringList list;
+	for (int i = 0; i < 6; ++i)
+	{
+		if (fields & (1 << i))
+		{
+			list.append(QString::fromLatin1(names[i]));
+		}
+	}
+	return list;
+}
+
+QVariantMap UserRecord::toVariantMap() const
+{
+	QVariantMap map;
+	map.insert("account_number", accountNumber);
+	map.insert("first_name", firstName);
+	map.insert("last_name", lastName);
+	map.insert("email", email);
+	map.insert("role", roleName(role));
+	map.insert("balance", balanceCents / 100.0);
+	return map;
+}
+
+void UserRecord::assignFields(const UserRecord& other, quint8 fields)
+{
+	if (fields & AccountNumberField)
+	{
+		accountNumber = other.accountNumber;
+	}
+	if (fields & FirstNameField)
+	{
+		firstName = other.firstName;
+	}
+	if (fields & LastNameField)
+	{
+		lastName = other.lastName;
+	}
+	if (fields & EmailField)
+	{
+		email = other.email;
+	}
+	if (fields & RoleField)
+	{
+		role = other.role;
+	}
+	if (fields & BalanceField)
+	{
+		balanceCents = other.balanceCents;
+	}
+}
+
+bool UserRecord::isSameUser(const UserRecord& other) const
+{
+	const bool hasAccount = role != Admin && accountNumber > 0;
+	const bool otherHasAccount = other.role != Admin && other.accountNumber > 0;
+
+	if (hasAccount || otherHasAccount)
+	{
+		return hasAccount && otherHasAccount && accountNumber == other.accountNumber;
+	}
+	return email == other.email;
+}
+
+bool UserRecord::operator==(const UserRecord& other) const
+{
+	return accountNumber == other.accountNumber && balanceCents == other.balanceCents && role == other.role &&
+		   firstName == other.firstName && lastName == other.lastName && email == other.email;
+}
+
+QString StringPool::intern(const QString& text)
+{
+	const auto it = strings_.constFind(text);
+	if (it != strings_.constEnd())
+	{
+		return *it;
+	}
+	strings_.insert(text);
+	return text;
+}
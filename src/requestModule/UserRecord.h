@@ -0,0 +1,118 @@
+/**
+ * @file UserRecord.h
+ * @brief Header file for the UserRecord structure.
+ *
+ * This file contains the declaration of the typed row of a GetDatabase reply, and of the pool
+ * sharing the text repeated across rows.
+ */
+
+#ifndef USERRECORD_H
+#define USERRECORD_H
+
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QStringView>
+#include <QVariantMap>
+
+/**
+ * @struct UserRecord
+ * @brief One user of the bank, as listed by GetDatabase.
+ *
+ * Numbers are kept as integers, the balance in cents, and the role as an enum. The names point to
+ * strings shared through a @ref StringPool, so the rows of users called alike hold a single copy.
+ */
+struct UserRecord
+{
+	/**
+	 * @enum Role
+	 * @brief The roles a user may have.
+	 */
+	enum Role : quint8
+	{
+		UnknownRole, ///< Role missing or not understood.
+		User,		 ///< Customer owning a bank account.
+		Admin		 ///< Administrator, without a bank account.
+	};
+
+	/**
+	 * @enum Field
+	 * @brief Flags naming the fields of a record, to request or tell apart a subset of them.
+	 */
+	enum Field : quint8
+	{
+		AccountNumberField = 0x01, ///< "account_number".
+		FirstNameField = 0x02,	   ///< "first_name".
+		LastNameField = 0x04,	   ///< "last_name".
+		EmailField = 0x08,		   ///< "email".
+		RoleField = 0x10,		   ///< "role".
+		BalanceField = 0x20,	   ///< "balance".
+		AllFields = 0x3f		   ///< Every field.
+	};
+
+	qint64	accountNumber = 0; ///< Account number, 0 for admins.
+	qint64	balanceCents = 0;  ///< Balance of the account, in cents.
+	Role	role = UnknownRole; ///< Role of the user.
+	QString firstName;		   ///< First name, shared with the other rows using it.
+	QString lastName;		   ///< Last name, shared with the other rows using it.
+	QString email;			   ///< Email of the user.
+
+	/**
+	 * @brief Returns the role matching "user" or "admin", UnknownRole otherwise.
+	 */
+	static Role roleFromString(QStringView text);
+
+	/**
+	 * @brief Returns the name of a role as sent by the server, empty for UnknownRole.
+	 */
+	static QString roleName(Role role);
+
+	/**
+	 * @brief Returns the names the server uses for a set of fields, in the order of the Field flags.
+	 *
+	 * @param fields A combination of Field flags.
+	 */
+	static QStringList fieldNames(quint8 fields);
+
+	/**
+	 * @brief Returns the record with the keys and value types the dialogs and requests use.
+	 */
+	QVariantMap toVariantMap() const;
+
+	/**
+	 * @brief Copies some fields of another record.
+	 *
+	 * @param other The record holding the new values.
+	 * @param fields A combination of Field flags naming the fields copied.
+	 */
+	void assignFields(const UserRecord& other, quint8 fields);
+
+	/**
+	 * @brief Tells whether two records describe the same user.
+	 *
+	 * Users are identified by account number, admins and users without an account by email.
+	 */
+	bool isSameUser(const UserRecord& other) const;
+
+	bool operator==(const UserRecord& other) const;
+};
+
+/**
+ * @class StringPool
+ * @brief Returns one shared QString for every distinct text it is given.
+ *
+ * A pool is meant to live for the decoding of one reply, it is not thread safe.
+ */
+class StringPool
+{
+public:
+	/**
+	 * @brief Returns the pooled copy of text, adding it on first use.
+	 */
+	QString intern(const QString& text);
+
+private:
+	QSet<QString> strings_; ///< The distinct texts seen so far.
+};
+
+#endif // USERRECORD_H
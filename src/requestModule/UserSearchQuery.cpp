@@ -0,0 +1,191 @@
+/**
+ * @file UserSearchQuery.cpp
+ * @brief Implementation file for the UserSearchQuery structure.
+ */
+#include "UserSearchQuery.h"
+#include "TransactionStore.h"
+
+namespace
+{
+bool isDigits(QStringView text)
+{
+	if (text.isEmpty())
+	{
+		return false;
+	}
+	for (QChar c : text)
+	{
+		if (!c.isDigit())
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * @brief Reads "low-high", "low-", "-high" or a single value, which sets both bounds.
+ *
+ * @param toValue Converts one bound, returning false if it is not a valid value.
+ * @return false if the range is not valid, the bounds are then left untouched.
+ */
+template <typename Convert>
+bool parseRange(QStringView text, qint64& low, qint64& high, Convert toValue)
+{
+	const qsizetype dash = text.indexOf(u'-');
+	qint64			from = UserSearchQuery::Unbounded;
+	qint64			to = UserSearchQuery::Unbounded;
+
+	if (dash < 0)
+	{
+		if (!toValue(text, from))
+		{
+			return false;
+		}
+		to = from;
+	}
+	else
+	{
+		const QStringView first = text.left(dash);
+		const QStringView last = text.mid(dash + 1);
+
+		if ((!first.isEmpty() && !toValue(first, from)) || (!last.isEmpty() && !toValue(last, to)) ||
+			(first.isEmpty() && last.isEmpty()))
+		{
+			return false;
+		}
+	}
+
+	low = from;
+	high = to;
+	return true;
+}
+
+bool toAccount(QStringView text, qint64& value)
+{
+	if (!isDigits(text))
+	{
+		return false;
+	}
+	value = text.toLongLong();
+	return true;
+}
+
+bool toBalanceCents(QStringView text, qint64& value)
+{
+	bool		 ok = false;
+	const double amount = text.toDouble(&ok);
+
+	if (!ok || amount < 0)
+	{
+		return false;
+	}
+	value = TransactionStore::toCents(amount);
+	return true;
+}
+} // namespace
+
+UserSearchQuery UserSearchQuery::parse(QStringView text)
+{
+	UserSearchQuery query;
+
+	for (QStringView term : text.split(u' ', Qt::SkipEmptyParts))
+	{
+		const qsizetype colon = term.indexOf(u':');
+		const QStringView key = colon < 0 ? QStringView() : term.left(colon);
+		const QStringView value = colon < 0 ? term : term.mid(colon + 1);
+
+		if (key == u"role")
+		{
+			query.role = UserRecord::roleFromString(value);
+		}
+		else if (key == u"account")
+		{
+			parseRange(value, query.minAccount, query.maxAccount, toAccount);
+		}
+		else if (key == u"balance")
+		{
+			parseRange(value, query.minBalanceCents, query.maxBalanceCents, toBalanceCents);
+		}
+		else if (key == u"email" || (key.isEmpty() && value.contains(u'@')))
+		{
+			query.emailPrefix = value.toString();
+		}
+		else if (key.isEmpty() && isDigits(value))
+		{
+			query.minAccount = query.maxAccount = value.toLongLong();
+		}
+		else if (key == u"name")
+		{
+			query.namePrefix = value.toString();
+		}
+		else if (key.isEmpty())
+		{
+			query.prefix = value.toString();
+		}
+	}
+	return query;
+}
+
+bool UserSearchQuery::isEmpty() const
+{
+	return prefix.isEmpty() && emailPrefix.isEmpty() && namePrefix.isEmpty() && minAccount == Unbounded && maxAccount == Unbounded &&
+		   role == UserRecord::UnknownRole && minBalanceCents == Unbounded && maxBalanceCents == Unbounded;
+}
+
+bool UserSearchQuery::matches(const UserRecord& user) const
+{
+	const auto startsWith = [](const QString& text, const QString& start)
+	{ return start.isEmpty() || text.startsWith(start, Qt::CaseInsensitive); };
+	const auto inRange = [](qint64 value, qint64 low, qint64 high)
+	{ return (low == Unbounded || value >= low) && (high == Unbounded || value <= high); };
+	const auto nameStartsWith = [&user, &startsWith](const QString& start)
+	{ return start.isEmpty() || (startsWith(user.firstName, start) || startsWith(user.lastName, start)); };
+
+	return (prefix.isEmpty() || startsWith(user.email, prefix) || nameStartsWith(prefix)) &&
+		   startsWith(user.email, emailPrefix) && nameStartsWith(namePrefix) &&
+		   inRange(user.accountNumber, minAccount, maxAccount) && (role == UserRecord::UnknownRole || user.role == role) &&
+		   inRange(user.balanceCents, minBalanceCents, maxBalanceCents);
+}
+
+QVariantMap UserSearchQuery::toVariantMap() const
+{
+	QVariantMap map;
+
+	// A bare term matches either field, unlike the other criteria which must all be met
+	if (!prefix.isEmpty())
+	{
+		map.insert("prefix", prefix);
+	}
+
+	if (!emailPrefix.isEmpty())
+	{
+		map.insert("email_prefix", emailPrefix);
+	}
+	if (!namePrefix.isEmpty())
+	{
+		map.insert("name_prefix", namePrefix);
+	}
+	if (minAccount != Unbounded)
+	{
+		map.insert("account_min", minAccount);
+	}
+	if (maxAccount != Unbounded)
+	{
+		map.insert("account_max", maxAccount);
+	}
+	if (role != UserRecord::UnknownRole)
+	{
+		map.insert("role", UserRecord::roleName(role));
+	}
+	// Amounts are sent like the "balance" of the users
+	if (minBalanceCents != Unbounded)
+	{
+		map.insert("balance_min", minBalanceCents / 100.0);
+	}
+	if (maxBalanceCents != Unbounded)
+	{
+		map.insert("balance_max", maxBalanceCents / 100.0);
+	}
+	return map;
+}
@@ -0,0 +1,66 @@
+/**
+ * @file UserSearchQuery.h
+ * @brief Header file for the UserSearchQuery structure.
+ *
+ * This file contains the declaration of the predicate sent with a SearchUsers request, and of its
+ * parsing from the text typed in the AdminWidget search field.
+ */
+
+#ifndef USERSEARCHQUERY_H
+#define USERSEARCHQUERY_H
+
+#include <QString>
+#include <QStringView>
+#include <QVariantMap>
+#include "UserRecord.h"
+
+/**
+ * @struct UserSearchQuery
+ * @brief The users wanted from a SearchUsers request.
+ *
+ * Every criterion is optional, a user matches when it meets all those that are set. Ranges are
+ * inclusive, and an unset bound is left open.
+ */
+struct UserSearchQuery
+{
+	static constexpr qint64 Unbounded = -1; ///< Value of a range bound that is not set.
+
+	QString			 prefix;						  ///< Start of the email or of the first or last name, ignoring case.
+	QString			 emailPrefix;					  ///< Start of the email, ignoring case.
+	QString			 namePrefix;					  ///< Start of the first or last name, ignoring case.
+	qint64			 minAccount = Unbounded;		  ///< Lowest account number.
+	qint64			 maxAccount = Unbounded;		  ///< Highest account number.
+	UserRecord::Role role = UserRecord::UnknownRole;  ///< Wanted role, UnknownRole for any.
+	qint64			 minBalanceCents = Unbounded;	  ///< Lowest balance, in cents.
+	qint64			 maxBalanceCents = Unbounded;	  ///< Highest balance, in cents.
+
+	/**
+	 * @brief Parses the text typed by the admin.
+	 *
+	 * The text is split on spaces. "role:", "account:", "balance:", "email:" and "name:" terms set the
+	 * matching criterion, ranges being written "low-high" with either end optional. Other terms made of
+	 * digits are an account number, terms containing '@' an email prefix, and any other term the start
+	 * of either the email or a name, as the local search index matches it.
+	 *
+	 * @param text The search text.
+	 * @return The query, empty if nothing was understood.
+	 */
+	static UserSearchQuery parse(QStringView text);
+
+	/**
+	 * @brief Tells whether no criterion is set.
+	 */
+	bool isEmpty() const;
+
+	/**
+	 * @brief Tells whether a user meets every criterion, as the server evaluates the query.
+	 */
+	bool matches(const UserRecord& user) const;
+
+	/**
+	 * @brief Returns the criteria that are set, with the keys sent to the server.
+	 */
+	QVariantMap toVariantMap() const;
+};
+
+#endif // USERSEARCHQUERY_H
@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+#include <QByteArray>
+
+#include "MessageFrame.h"
+
+// Test Fixture
+class FrameReassemblerTest : public ::testing::Test
+{
+protected:
+	FrameReassembler reassembler;
+	QByteArray		 payload;
+	quint8			 flags = 0;
+};
+
+TEST_F(FrameReassemblerTest, Encode_AddsHeaderAndDigest)
+{
+	QByteArray frame = MessageFrame::encode("{\"Response\":3}");
+
+	EXPECT_EQ(frame.size(), MessageFrame::HeaderSize + 14 + MessageFrame::DigestSize);
+}
+
+TEST_F(FrameReassemblerTest, TakeFrame_EmptyBuffer_NeedsMoreData)
+{
+	EXPECT_EQ(reassembler.takeFrame(payload, flags), FrameReassembler::NeedMoreData);
+}
+
+TEST_F(FrameReassemblerTest, TakeFrame_SplitFrame_DeliveredOnceComplete)
+{
+	QByteArray message(100000, 'x');
+	QByteArray frame = MessageFrame::encode(message, 0x02);
+
+	// Feed the frame in small segments, as TCP may deliver it
+	for (qsizetype pos = 0; pos < frame.size(); pos += 1460)
+	{
+		EXPECT_EQ(reassembler.takeFrame(payload, flags), FrameReassembler::NeedMoreData);
+		reassembler.append(frame.mid(pos, 1460));
+	}
+
+	EXPECT_EQ(reassembler.takeFrame(payload, flags), FrameReassembler::FrameReady);
+	EXPECT_EQ(payload, message);
+	EXPECT_EQ(flags, 0x02);
+	EXPECT_EQ(reassembler.bufferedBytes(), 0);
+}
+
+TEST_F(FrameReassemblerTest, TakeFrame_MergedFrames_DeliveredOneByOne)
+{
+	reassembler.append(MessageFrame::encode("first") + MessageFrame::encode("second"));
+
+	EXPECT_EQ(reassembler.takeFrame(payload, flags), FrameReassembler::FrameReady);
+	EXPECT_EQ(payload, "first");
+	EXPECT_EQ(reassembler.takeFrame(payload, flags), FrameReassembler::FrameReady);
+	EXPECT_EQ(payload, "second");
+	EXPECT_EQ(reassembler.takeFrame(payload, flags), FrameReassembler::NeedMoreData);
+}
+
+TEST_F(FrameReassemblerTest, TakeFrame_WrongDigest_SkipsOnlyThatFrame)
+{
+	QByteArray corrupted = MessageFrame::encode("first");
+	corrupted[MessageFrame::HeaderSize] = 'F';
+
+	reassembler.append(corrupted + MessageFrame::encode("second"));
+
+	EXPECT_EQ(reassembler.takeFrame(payload, flags), FrameReassembler::CorruptFrame);
+	EXPECT_EQ(reassembler.takeFrame(payload, flags), FrameReassembler::FrameReady);
+	EXPECT_EQ(payload, "second");
+}
+
+TEST_F(FrameReassemblerTest, TakeFrame_WrongMagic_DropsBuffer)
+{
+	reassembler.append(QByteArray("not a frame at all"));
+
+	EXPECT_EQ(reassembler.takeFrame(payload, flags), FrameReassembler::CorruptFrame);
+	EXPECT_EQ(reassembler.bufferedBytes(), 0);
+}
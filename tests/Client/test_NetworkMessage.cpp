@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+#include <QCoreApplication>
+#include <QSemaphore>
+#include <QThread>
+
+#include "ClientHandler.h"
+#include "NetworkMessage.h"
+
+// Test Fixture
+class NetworkMessageTest : public ::testing::Test
+{
+protected:
+	static void SetUpTestSuite()
+	{
+		// Queued connections need an application object
+		if (QCoreApplication::instance() == nullptr)
+		{
+			static int	argc = 1;
+			static char name[] = "Client_tests";
+			static char* argv[] = {name, nullptr};
+			new QCoreApplication(argc, argv);
+		}
+	}
+};
+
+TEST_F(NetworkMessageTest, FromPayload_KeepsTheBuffer)
+{
+	QByteArray	payload(4096, 'x');
+	const char* buffer = payload.constData();
+
+	MessagePtr message = NetworkMessage::fromPayload(std::move(payload), MessageCodec::Json);
+
+	EXPECT_EQ(message->payload().constData(), buffer);
+	EXPECT_TRUE(message->isEncoded());
+}
+
+TEST_F(NetworkMessageTest, Handoff_AcrossThreads_SharesThePayload)
+{
+	ClientHandler handler;
+	QThread		  decodeThread;
+	QObject		  receiver;
+	QSemaphore	  delivered;
+	MessagePtr	  received;
+
+	receiver.moveToThread(&decodeThread);
+	QObject::connect(&handler, &ClientHandler::sendResponseBack, &receiver,
+					 [&](MessagePtr message)
+					 {
+						 received = message;
+						 delivered.release();
+					 });
+	decodeThread.start();
+
+	QByteArray	payload = R"({"Response":3,"Data":{"status":1,"balance":10}})";
+	const char* buffer = payload.constData();
+	MessagePtr	sent = NetworkMessage::fromPayload(std::move(payload), MessageCodec::Json);
+
+	handler.onResponseReady(sent);
+
+	ASSERT_TRUE(delivered.tryAcquire(1, 5000));
+	decodeThread.quit();
+	decodeThread.wait();
+
+	// Same message object and same payload buffer on the receiving thread: nothing was copied
+	EXPECT_EQ(received.data(), sent.data());
+	EXPECT_EQ(received->payload().constData(), buffer);
+
+	// The buffer has a single owner, the message, so no QByteArray copy of it was kept on the way
+	EXPECT_TRUE(received->payload().isDetached());
+
+	// The message is the only one allocated: once both handles are dropped, nothing else holds it
+	QWeakPointer<const NetworkMessage> tracker = sent;
+
+	sent.reset();
+	EXPECT_FALSE(tracker.isNull());
+	received.reset();
+	EXPECT_TRUE(tracker.isNull());
+}
+
+TEST_F(NetworkMessageTest, MalformedReply_IsDropped)
+{
+	ClientHandler handler;
+	int			  forwarded = 0;
+
+	QObject::connect(&handler, &ClientHandler::sendResponseBack, [&forwarded](MessagePtr) { ++forwarded; });
+
+	handler.onResponseReady(NetworkMessage::fromPayload("{\"Response\":", MessageCodec::Json));
+	handler.onResponseReady(NetworkMessage::fromPayload("not json", MessageCodec::Json));
+
+	EXPECT_EQ(forwarded, 0);
+
+	// Replies without a RequestId, such as pushed events, are still forwarded
+	handler.onResponseReady(NetworkMessage::fromPayload(R"({"Response":7,"Data":{}})", MessageCodec::Json));
+	EXPECT_EQ(forwarded, 1);
+}
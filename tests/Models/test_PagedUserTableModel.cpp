@@ -0,0 +1,208 @@
+#include <gtest/gtest.h>
+#include <QAbstractItemModelTester>
+#include <QCoreApplication>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QSignalSpy>
+
+#include "NetworkMessage.h"
+#include "PagedUserTableModel.h"
+#include "RequestManager.h"
+
+namespace
+{
+UserPage makePage(qint64 requestId, int offset, int count, int total)
+{
+	UserPage page;
+	page.requestId = requestId;
+	page.offset = offset;
+	page.total = total;
+	for (int i = offset + 1; i <= offset + count; ++i)
+	{
+		UserRecord user;
+		user.accountNumber = i;
+		user.email = QString("user%1@bank.io").arg(i);
+		user.role = UserRecord::User;
+		page.users.append(user);
+	}
+	return page;
+}
+} // namespace
+
+// Test Fixture
+class PagedUserTableModelTest : public ::testing::Test
+{
+protected:
+	PagedUserTableModel*	   model;
+	QAbstractItemModelTester* tester;
+	QSignalSpy*				   requestSpy;
+
+	static void SetUpTestSuite()
+	{
+		if (QCoreApplication::instance() == nullptr)
+		{
+			static int	argc = 1;
+			static char name[] = "Models_tests";
+			static char* argv[] = {name, nullptr};
+			new QCoreApplication(argc, argv);
+		}
+	}
+
+	void SetUp() override
+	{
+		requestSpy = new QSignalSpy(RequestManager::getInstance(), &RequestManager::makeRequest);
+		model = new PagedUserTableModel(QVariantMap());
+		model->setPageSize(100);
+		tester = new QAbstractItemModelTester(model, QAbstractItemModelTester::FailureReportingMode::Fatal);
+	}
+
+	void TearDown() override
+	{
+		delete tester;
+		delete model;
+		delete requestSpy;
+	}
+
+	/// Returns the data of the last page request sent for an offset, empty if none was sent.
+	QJsonObject lastRequestFor(int offset) const
+	{
+		for (qsizetype i = requestSpy->count() - 1; i >= 0; --i)
+		{
+			const QJsonObject envelope = requestSpy->at(i).first().value<MessagePtr>()->envelope();
+			if (envelope.value("Data").toObject().value("offset").toVariant().toLongLong() == offset)
+			{
+				return envelope;
+			}
+		}
+		return QJsonObject();
+	}
+
+	static qint64 requestIdOf(const QJsonObject& envelope)
+	{
+		return envelope.value("RequestId").toVariant().toLongLong();
+	}
+};
+
+TEST_F(PagedUserTableModelTest, Rows_RequestTheirPageOnce)
+{
+	model->refresh();
+	const QJsonObject first = lastRequestFor(0);
+	ASSERT_FALSE(first.isEmpty());
+
+	ASSERT_TRUE(model->applyPage(makePage(requestIdOf(first), 0, 100, 250)));
+	ASSERT_EQ(model->rowCount(), 250);
+	EXPECT_EQ(model->data(model->index(5, UserTableModel::AccountNumber)).toString(), "6");
+
+	// Reading rows never sends a request, a row of a page not loaded is empty until the view shows it
+	qsizetype sent = requestSpy->count();
+	EXPECT_FALSE(model->data(model->index(150, UserTableModel::AccountNumber)).isValid());
+	EXPECT_EQ(requestSpy->count(), sent);
+
+	// Rows shown over two pages request the one not cached, once
+	model->ensureRowsLoaded(90, 160);
+	const QJsonObject second = lastRequestFor(100);
+	ASSERT_FALSE(second.isEmpty());
+	EXPECT_EQ(requestSpy->count(), sent + 1);
+
+	sent = requestSpy->count();
+	model->ensureRowsLoaded(140, 180);
+	EXPECT_EQ(requestSpy->count(), sent);
+
+	QSignalSpy changedSpy(model, &QAbstractItemModel::dataChanged);
+	ASSERT_TRUE(model->applyPage(makePage(requestIdOf(second), 100, 100, 250)));
+	ASSERT_EQ(changedSpy.count(), 1);
+	EXPECT_EQ(changedSpy.at(0).at(0).toModelIndex().row(), 100);
+	EXPECT_EQ(changedSpy.at(0).at(1).toModelIndex().row(), 199);
+	EXPECT_EQ(model->data(model->index(150, UserTableModel::AccountNumber)).toString(), "151");
+
+	// Replies to requests of other models, or answered already, are left to the caller
+	EXPECT_FALSE(model->applyPage(makePage(requestIdOf(second), 100, 100, 250)));
+	EXPECT_FALSE(model->applyPage(makePage(-1, 0, 100, 250)));
+}
+
+TEST_F(PagedUserTableModelTest, Refresh_SendsTheVersionAndKeepsPagesNotModified)
+{
+	model->refresh();
+	UserPage page = makePage(requestIdOf(lastRequestFor(0)), 0, 100, 100);
+	page.version = "v1";
+	ASSERT_TRUE(model->applyPage(page));
+
+	model->refresh();
+	const QJsonObject again = lastRequestFor(0);
+	EXPECT_EQ(again.value("Data").toObject().value("if_version").toString(), "v1");
+
+	QSignalSpy resetSpy(model, &QAbstractItemModel::modelReset);
+	EXPECT_TRUE(model->applyNotModified(requestIdOf(again)));
+	EXPECT_EQ(resetSpy.count(), 0);
+
+	// The page is current again, showing it sends nothing
+	const qsizetype sent = requestSpy->count();
+	model->ensureRowsLoaded(0, 30);
+	EXPECT_EQ(model->data(model->index(0, UserTableModel::AccountNumber)).toString(), "1");
+	EXPECT_EQ(requestSpy->count(), sent);
+}
+
+TEST_F(PagedUserTableModelTest, Refresh_RequestsOnlyThePagesShown)
+{
+	model->refresh();
+	ASSERT_TRUE(model->applyPage(makePage(requestIdOf(lastRequestFor(0)), 0, 100, 1000)));
+	model->ensureRowsLoaded(520, 560);
+	ASSERT_TRUE(model->applyPage(makePage(requestIdOf(lastRequestFor(500)), 500, 100, 1000)));
+
+	// The first page and the page shown are asked for again, the other rows are left alone
+	QSignalSpy changedSpy(model, &QAbstractItemModel::dataChanged);
+	const qsizetype sent = requestSpy->count();
+	model->refresh();
+
+	EXPECT_EQ(requestSpy->count(), sent + 2);
+	EXPECT_GT(requestIdOf(lastRequestFor(500)), requestIdOf(lastRequestFor(0)));
+	EXPECT_EQ(changedSpy.count(), 0);
+}
+
+TEST_F(PagedUserTableModelTest, ApplyChanges_UpdatesCachedRowsOnly)
+{
+	model->refresh();
+	ASSERT_TRUE(model->applyPage(makePage(requestIdOf(lastRequestFor(0)), 0, 100, 250)));
+
+	UserRecord user;
+	user.accountNumber = 42;
+	user.role = UserRecord::User;
+	user.balanceCents = 1250;
+
+	UserChange updated;
+	updated.kind = UserChange::Updated;
+	updated.users = {user};
+	updated.fields = UserRecord::AccountNumberField | UserRecord::BalanceField;
+
+	QSignalSpy changedSpy(model, &QAbstractItemModel::dataChanged);
+	model->applyChanges({updated});
+
+	ASSERT_EQ(changedSpy.count(), 1);
+	EXPECT_EQ(changedSpy.at(0).at(0).toModelIndex().row(), 41);
+	EXPECT_EQ(changedSpy.at(0).at(1).toModelIndex().row(), 41);
+	EXPECT_EQ(model->data(model->index(41, UserTableModel::Balance)).toString(), "12.50");
+	EXPECT_EQ(model->data(model->index(41, UserTableModel::Email)).toString(), "user42@bank.io");
+
+	// A created user moves the rows after it, so the pages are requested again
+	UserChange created;
+	created.kind = UserChange::Created;
+	created.users = {user};
+
+	const qsizetype sent = requestSpy->count();
+	model->applyChanges({created});
+	EXPECT_GT(requestSpy->count(), sent);
+}
+
+TEST_F(PagedUserTableModelTest, SetFields_NamesThemInThePageRequests)
+{
+	model->refresh();
+	EXPECT_FALSE(lastRequestFor(0).value("Data").toObject().contains("fields"));
+
+	model->setFields(UserRecord::AccountNumberField | UserRecord::EmailField);
+	model->refresh();
+
+	const QJsonArray fields = lastRequestFor(0).value("Data").toObject().value("fields").toArray();
+	ASSERT_EQ(fields.size(), 2);
+	EXPECT_EQ(fields.at(0).toString(), "account_number");
+	EXPECT_EQ(fields.at(1).toString(), "email");
+}
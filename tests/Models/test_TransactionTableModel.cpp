@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+#include <QAbstractItemModelTester>
+#include <QCoreApplication>
+#include <QJsonObject>
+#include <QSignalSpy>
+
+#include "NetworkMessage.h"
+#include "RequestManager.h"
+#include "TransactionTableModel.h"
+
+namespace
+{
+TransactionStore::Row makeRow(qint64 amountCents, qint64 createdAt)
+{
+	TransactionStore::Row row;
+	row.fromAccount = 1001;
+	row.toAccount = 1002;
+	row.amountCents = amountCents;
+	row.createdAt = createdAt;
+	return row;
+}
+
+TransactionPage makePage(qint64 requestId, const QList<TransactionStore::Row>& rows)
+{
+	TransactionPage page;
+	page.requestId = requestId;
+	for (const TransactionStore::Row& row : rows)
+	{
+		page.rows.append(row);
+	}
+	return page;
+}
+} // namespace
+
+// Test Fixture
+class TransactionTableModelTest : public ::testing::Test
+{
+protected:
+	TransactionTableModel*	   model;
+	QAbstractItemModelTester* tester;
+
+	static void SetUpTestSuite()
+	{
+		if (QCoreApplication::instance() == nullptr)
+		{
+			static int	argc = 1;
+			static char name[] = "Models_tests";
+			static char* argv[] = {name, nullptr};
+			new QCoreApplication(argc, argv);
+		}
+	}
+
+	void SetUp() override
+	{
+		model = new TransactionTableModel(QVariantMap());
+		tester = new QAbstractItemModelTester(model, QAbstractItemModelTester::FailureReportingMode::Fatal);
+	}
+
+	void TearDown() override
+	{
+		delete tester;
+		delete model;
+	}
+};
+
+TEST_F(TransactionTableModelTest, Refresh_DeltaAtTheSinceDate_DropsTheRowsShown)
+{
+	RequestManager* requestManager = RequestManager::getInstance();
+	const qint64	newest = TransactionStore::parseTimestamp(u"2024-06-01T10:00:00.250Z");
+
+	const TransactionStore::Row shownA = makeRow(100, newest);
+	const TransactionStore::Row shownB = makeRow(200, newest);
+	const TransactionStore::Row older = makeRow(300, newest - 60000);
+
+	model->refresh();
+	TransactionPage first = makePage(requestManager->lastRequestId(), {shownA, shownB, older});
+	first.version = "v1";
+	ASSERT_TRUE(model->applyPage(first));
+	ASSERT_EQ(model->rowCount(), 3);
+
+	QSignalSpy requestSpy(requestManager, &RequestManager::makeRequest);
+	model->refresh();
+
+	// "since" is an unambiguous UTC instant, whatever the server's time zone
+	ASSERT_EQ(requestSpy.count(), 1);
+	const QJsonObject data = requestSpy.at(0).first().value<MessagePtr>()->envelope().value("Data").toObject();
+	EXPECT_EQ(data.value("since").toString(), "2024-06-01T10:00:00.250Z");
+	EXPECT_EQ(data.value("if_version").toString(), "v1");
+
+	// "since" is inclusive: the rows of that date already shown come back with a new one of the same date
+	const TransactionStore::Row sameDate = makeRow(250, newest);
+	const TransactionStore::Row newer = makeRow(400, newest + 1000);
+	TransactionPage delta = makePage(requestManager->lastRequestId(), {newer, shownA, sameDate, shownB});
+	delta.isDelta = true;
+
+	QSignalSpy resetSpy(model, &QAbstractItemModel::modelReset);
+	QSignalSpy insertedSpy(model, &QAbstractItemModel::rowsInserted);
+	QSignalSpy refreshedSpy(model, &TransactionTableModel::refreshed);
+	ASSERT_TRUE(model->applyPage(delta));
+
+	EXPECT_EQ(resetSpy.count(), 0);
+	ASSERT_EQ(insertedSpy.count(), 1);
+	EXPECT_EQ(insertedSpy.at(0).at(1).toInt(), 0);
+	EXPECT_EQ(insertedSpy.at(0).at(2).toInt(), 1);
+	ASSERT_EQ(refreshedSpy.count(), 1);
+	EXPECT_EQ(refreshedSpy.at(0).at(0).toInt(), 2);
+
+	ASSERT_EQ(model->rowCount(), 5);
+	const QStringList amounts = {"4.00", "2.50", "1.00", "2.00", "3.00"};
+	for (int row = 0; row < amounts.size(); ++row)
+	{
+		EXPECT_EQ(model->data(model->index(row, TransactionTableModel::Amount)).toString(), amounts.at(row));
+	}
+}
+
+TEST_F(TransactionTableModelTest, Refresh_DeltaWithAGap_StartsOver)
+{
+	RequestManager* requestManager = RequestManager::getInstance();
+	const qint64	newest = TransactionStore::parseTimestamp(u"2024-06-01 10:00:00");
+
+	model->refresh();
+	ASSERT_TRUE(model->applyPage(makePage(requestManager->lastRequestId(), {makeRow(100, newest)})));
+
+	model->refresh();
+	TransactionPage delta = makePage(requestManager->lastRequestId(), {makeRow(500, newest + 2000)});
+	delta.isDelta = true;
+	delta.hasMore = true;
+
+	QSignalSpy resetSpy(model, &QAbstractItemModel::modelReset);
+	ASSERT_TRUE(model->applyPage(delta));
+
+	EXPECT_EQ(resetSpy.count(), 1);
+	ASSERT_EQ(model->rowCount(), 1);
+	EXPECT_EQ(model->data(model->index(0, TransactionTableModel::Amount)).toString(), "5.00");
+}
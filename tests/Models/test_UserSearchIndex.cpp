@@ -0,0 +1,38 @@
+#include <gtest/gtest.h>
+
+#include "UserSearchIndex.h"
+
+namespace
+{
+UserRecord makeUser(qint64 accountNumber, const QString& email, UserRecord::Role role)
+{
+	UserRecord user;
+	user.accountNumber = accountNumber;
+	user.email = email;
+	user.role = role;
+	return user;
+}
+} // namespace
+
+TEST(UserSearchIndexTest, AccountLookup_SkipsUsersWithoutAccount)
+{
+	QList<UserRecord> users = {makeUser(0, "root@bank.io", UserRecord::Admin),
+							   makeUser(100001, "jane@bank.io", UserRecord::User),
+							   makeUser(0, "ops@bank.io", UserRecord::Admin)};
+
+	UserSearchIndex index;
+	index.reset(users);
+
+	EXPECT_TRUE(index.find(u"0", 10).isEmpty());
+	EXPECT_EQ(index.find(u"100001", 10), QList<int>({1}));
+
+	// Removing an admin renumbers the rows after it, the other admin still has no account entry
+	users.removeFirst();
+	UserTableModel::RowEdit edit;
+	edit.removed = {0};
+	index.applyEdit(users, edit);
+
+	EXPECT_TRUE(index.find(u"0", 10).isEmpty());
+	EXPECT_EQ(index.find(u"100001", 10), QList<int>({0}));
+	EXPECT_EQ(index.find(u"ops", 10), QList<int>({1}));
+}
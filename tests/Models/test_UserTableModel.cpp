@@ -0,0 +1,268 @@
+#include <gtest/gtest.h>
+#include <QAbstractItemModelTester>
+#include <QCoreApplication>
+#include <QList>
+#include <QSignalSpy>
+
+#include "SortableTableModel.h"
+#include "UserTableModel.h"
+
+namespace
+{
+UserRecord makeUser(qint64 accountNumber, qint64 balanceCents = 0)
+{
+	UserRecord user;
+	user.accountNumber = accountNumber;
+	user.firstName = "First" + QString::number(accountNumber);
+	user.lastName = "Last" + QString::number(accountNumber);
+	user.email = QString("user%1@bank.io").arg(accountNumber);
+	user.role = UserRecord::User;
+	user.balanceCents = balanceCents;
+	return user;
+}
+
+QList<UserRecord> makeUsers(int count)
+{
+	QList<UserRecord> users;
+	for (int i = 1; i <= count; ++i)
+	{
+		users.append(makeUser(i, i * 100));
+	}
+	return users;
+}
+} // namespace
+
+// Test Fixture
+class UserTableModelTest : public ::testing::Test
+{
+protected:
+	UserTableModel*			   model;
+	QAbstractItemModelTester* tester;
+
+	static void SetUpTestSuite()
+	{
+		// Sorts are delivered through queued signals
+		if (QCoreApplication::instance() == nullptr)
+		{
+			static int	argc = 1;
+			static char name[] = "Models_tests";
+			static char* argv[] = {name, nullptr};
+			new QCoreApplication(argc, argv);
+		}
+	}
+
+	void SetUp() override
+	{
+		model = new UserTableModel();
+		tester = new QAbstractItemModelTester(model, QAbstractItemModelTester::FailureReportingMode::Fatal);
+	}
+
+	void TearDown() override
+	{
+		delete tester;
+		delete model;
+	}
+};
+
+TEST_F(UserTableModelTest, SetUsers_EditDeleteInsert_NotifiesOnlyThoseRows)
+{
+	model->setUsers(makeUsers(10));
+
+	QList<UserRecord> next = makeUsers(10);
+	next[1].balanceCents = 1;
+	next.removeAt(2);
+	next.append(makeUser(11));
+
+	QSignalSpy resetSpy(model, &QAbstractItemModel::modelReset);
+	QSignalSpy changedSpy(model, &QAbstractItemModel::dataChanged);
+	QSignalSpy removedSpy(model, &QAbstractItemModel::rowsRemoved);
+	QSignalSpy insertedSpy(model, &QAbstractItemModel::rowsInserted);
+
+	const UserTableModel::RowEdit edit = model->setUsers(next);
+
+	EXPECT_FALSE(edit.reset);
+	EXPECT_EQ(edit.changed, QList<int>({1}));
+	EXPECT_EQ(edit.removed, QList<int>({2}));
+	EXPECT_EQ(edit.appended, 1);
+
+	EXPECT_EQ(resetSpy.count(), 0);
+	ASSERT_EQ(changedSpy.count(), 1);
+	EXPECT_EQ(changedSpy.at(0).at(0).toModelIndex().row(), 1);
+	EXPECT_EQ(changedSpy.at(0).at(1).toModelIndex().row(), 1);
+	ASSERT_EQ(removedSpy.count(), 1);
+	EXPECT_EQ(removedSpy.at(0).at(1).toInt(), 2);
+	EXPECT_EQ(removedSpy.at(0).at(2).toInt(), 2);
+	ASSERT_EQ(insertedSpy.count(), 1);
+	EXPECT_EQ(insertedSpy.at(0).at(1).toInt(), 9);
+	EXPECT_EQ(insertedSpy.at(0).at(2).toInt(), 9);
+
+	ASSERT_EQ(model->rowCount(), 10);
+	EXPECT_EQ(model->userAt(1).balanceCents, 1);
+	EXPECT_EQ(model->userAt(2).accountNumber, 4);
+	EXPECT_EQ(model->userAt(9).accountNumber, 11);
+}
+
+TEST_F(UserTableModelTest, SetUsers_MostRowsDiffer_ResetsTheModel)
+{
+	model->setUsers(makeUsers(10));
+
+	QSignalSpy resetSpy(model, &QAbstractItemModel::modelReset);
+	const UserTableModel::RowEdit edit = model->setUsers(makeUsers(3));
+
+	EXPECT_TRUE(edit.reset);
+	EXPECT_EQ(resetSpy.count(), 1);
+	EXPECT_EQ(model->rowCount(), 3);
+}
+
+TEST_F(UserTableModelTest, ApplyChanges_PatchesRowsInPlace)
+{
+	model->setUsers(makeUsers(10));
+
+	UserChange updated;
+	updated.kind = UserChange::Updated;
+	updated.users = {makeUser(3, 42)};
+	updated.fields = UserRecord::AccountNumberField | UserRecord::BalanceField;
+
+	UserChange deleted;
+	deleted.kind = UserChange::Deleted;
+	deleted.users = {makeUser(5)};
+
+	UserChange created;
+	created.kind = UserChange::Created;
+	created.users = {makeUser(11, 500), makeUser(12)};
+
+	// A user created then deleted in the same batch is never shown
+	UserChange createdThenDeleted;
+	createdThenDeleted.kind = UserChange::Deleted;
+	createdThenDeleted.users = {makeUser(12)};
+
+	UserChange createdThenUpdated = updated;
+	createdThenUpdated.users = {makeUser(11, 700)};
+
+	QSignalSpy resetSpy(model, &QAbstractItemModel::modelReset);
+	QSignalSpy changedSpy(model, &QAbstractItemModel::dataChanged);
+	QSignalSpy removedSpy(model, &QAbstractItemModel::rowsRemoved);
+	QSignalSpy insertedSpy(model, &QAbstractItemModel::rowsInserted);
+
+	const UserTableModel::RowEdit edit =
+		model->applyChanges({updated, deleted, created, createdThenDeleted, createdThenUpdated});
+
+	EXPECT_FALSE(edit.reset);
+	EXPECT_EQ(edit.changed, QList<int>({2}));
+	EXPECT_EQ(edit.removed, QList<int>({4}));
+	EXPECT_EQ(edit.appended, 1);
+
+	EXPECT_EQ(resetSpy.count(), 0);
+	ASSERT_EQ(changedSpy.count(), 1);
+	EXPECT_EQ(changedSpy.at(0).at(0).toModelIndex().row(), 2);
+	ASSERT_EQ(removedSpy.count(), 1);
+	EXPECT_EQ(removedSpy.at(0).at(1).toInt(), 4);
+	ASSERT_EQ(insertedSpy.count(), 1);
+	EXPECT_EQ(insertedSpy.at(0).at(1).toInt(), 9);
+	EXPECT_EQ(insertedSpy.at(0).at(2).toInt(), 9);
+
+	ASSERT_EQ(model->rowCount(), 10);
+	EXPECT_EQ(model->userAt(2).balanceCents, 42);
+	EXPECT_EQ(model->userAt(2).lastName, "Last3");
+	EXPECT_EQ(model->userAt(4).accountNumber, 6);
+	EXPECT_EQ(model->userAt(9).accountNumber, 11);
+	EXPECT_EQ(model->userAt(9).balanceCents, 700);
+
+	// The key index follows the rows that moved
+	UserChange moved = updated;
+	moved.users = {makeUser(11, 1)};
+	EXPECT_EQ(model->applyChanges({moved}).changed, QList<int>({9}));
+	EXPECT_EQ(model->applyChanges({deleted}).removed, QList<int>());
+}
+
+TEST_F(UserTableModelTest, ApplyChanges_SortedView_RemovesTheShownRows)
+{
+	model->setUsers(makeUsers(10));
+
+	QSignalSpy sortedSpy(model, &SortableTableModel::sorted);
+	model->sortByColumns({{UserTableModel::Balance, Qt::DescendingOrder}});
+	ASSERT_TRUE(sortedSpy.wait(5000));
+	ASSERT_EQ(model->userAt(0).accountNumber, 10);
+
+	UserChange deleted;
+	deleted.kind = UserChange::Deleted;
+	deleted.users = {makeUser(10), makeUser(9), makeUser(1)};
+
+	QSignalSpy removedSpy(model, &QAbstractItemModel::rowsRemoved);
+	model->applyChanges({deleted});
+
+	// Rows 0-1 and 9 are shown, removed as two ranges from the bottom up
+	ASSERT_EQ(removedSpy.count(), 2);
+	EXPECT_EQ(removedSpy.at(0).at(1).toInt(), 9);
+	EXPECT_EQ(removedSpy.at(1).at(1).toInt(), 0);
+	EXPECT_EQ(removedSpy.at(1).at(2).toInt(), 1);
+
+	ASSERT_EQ(model->rowCount(), 7);
+	EXPECT_EQ(model->userAt(0).accountNumber, 8);
+	EXPECT_EQ(model->userAt(6).accountNumber, 2);
+}
+
+TEST_F(UserTableModelTest, Sort_ChangedWhileSorting_DropsTheStaleOrder)
+{
+	model->setUsers(makeUsers(1000));
+
+	QSignalSpy sortedSpy(model, &SortableTableModel::sorted);
+	model->sortByColumns({{UserTableModel::Balance, Qt::AscendingOrder}});
+
+	// The sort in flight was computed from the old balances
+	QList<UserRecord> next = makeUsers(1000);
+	next[0].balanceCents = 1000000;
+	next[999].balanceCents = 0;
+	model->setUsers(next);
+
+	ASSERT_TRUE(sortedSpy.wait(5000));
+	EXPECT_FALSE(sortedSpy.wait(200));
+	EXPECT_EQ(sortedSpy.count(), 1);
+
+	EXPECT_EQ(model->userAt(0).accountNumber, 1000);
+	EXPECT_EQ(model->userAt(999).accountNumber, 1);
+	for (int row = 1; row < model->rowCount(); ++row)
+	{
+		EXPECT_LE(model->userAt(row - 1).balanceCents, model->userAt(row).balanceCents);
+	}
+}
+
+TEST(SortableTableModelTest, SortedOrder_EqualKeys_KeepSourceOrderAcrossChunks)
+{
+	// Above the parallel threshold, chunks sorted apart must merge back in a stable order
+	const int rows = 1 << 17;
+
+	SortableTableModel::SortKey key;
+	key.order = Qt::DescendingOrder;
+	for (int row = 0; row < rows; ++row)
+	{
+		key.integers.append(row % 7);
+	}
+
+	const QList<int> order = SortableTableModel::sortedOrder({key}, rows);
+
+	ASSERT_EQ(order.size(), rows);
+	for (int i = 1; i < rows; ++i)
+	{
+		const qint64 previous = key.integers.at(order.at(i - 1));
+		const qint64 current = key.integers.at(order.at(i));
+
+		ASSERT_GE(previous, current) << "at position " << i;
+		if (previous == current)
+		{
+			ASSERT_LT(order.at(i - 1), order.at(i)) << "at position " << i;
+		}
+	}
+}
+
+TEST(SortableTableModelTest, SortedOrder_SecondaryKey_BreaksTies)
+{
+	SortableTableModel::SortKey names;
+	names.texts = {"b", "a", "b", "a"};
+
+	SortableTableModel::SortKey balances;
+	balances.integers = {1, 2, 3, 2};
+	balances.order = Qt::DescendingOrder;
+
+	EXPECT_EQ(SortableTableModel::sortedOrder({names, balances}, 4), QList<int>({1, 3, 2, 0}));
+}
@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+#include <QJsonObject>
+#include <QSignalSpy>
+
+#include "NetworkMessage.h"
+#include "RequestManager.h"
+
+TEST(RequestManagerTest, Session_ReplacesIdentityFields)
+{
+	RequestManager* requestManager = RequestManager::getInstance();
+	QSignalSpy		requestSpy(requestManager, &RequestManager::makeRequest);
+
+	requestManager->openSession("a@b.c");
+	requestManager->createRequest(RequestManager::GetDatabase, QVariantMap());
+	requestManager->setSessionToken("t0k3n");
+	requestManager->createRequest(RequestManager::GetDatabase, QVariantMap());
+	requestManager->closeSession();
+
+	ASSERT_EQ(requestSpy.count(), 2);
+	const QJsonObject byEmail = requestSpy.at(0).first().value<MessagePtr>()->envelope();
+	const QJsonObject byToken = requestSpy.at(1).first().value<MessagePtr>()->envelope();
+
+	EXPECT_EQ(byEmail.value("Data").toObject().value("email").toString(), "a@b.c");
+	EXPECT_FALSE(byEmail.contains("Session"));
+	EXPECT_EQ(byToken.value("Session").toString(), "t0k3n");
+	EXPECT_FALSE(byToken.value("Data").toObject().contains("email"));
+}
+
+TEST(RequestManagerTest, Session_FollowsEmailChange)
+{
+	RequestManager* requestManager = RequestManager::getInstance();
+	QSignalSpy		requestSpy(requestManager, &RequestManager::makeRequest);
+
+	// The widgets open the session again once "Email updated successfully" is received
+	requestManager->openSession("old@b.c");
+	requestManager->createRequest(RequestManager::GetBalance, QVariantMap());
+	requestManager->openSession("new@b.c");
+	requestManager->createRequest(RequestManager::GetBalance, QVariantMap());
+	requestManager->closeSession();
+
+	ASSERT_EQ(requestSpy.count(), 2);
+	const QJsonObject before = requestSpy.at(0).first().value<MessagePtr>()->envelope();
+	const QJsonObject after = requestSpy.at(1).first().value<MessagePtr>()->envelope();
+
+	EXPECT_EQ(before.value("Data").toObject().value("email").toString(), "old@b.c");
+	EXPECT_EQ(after.value("Data").toObject().value("email").toString(), "new@b.c");
+}
+
+TEST(RequestManagerTest, Backpressure_CoalescesRepeatedReads)
+{
+	RequestManager* requestManager = RequestManager::getInstance();
+	QSignalSpy		requestSpy(requestManager, &RequestManager::makeRequest);
+
+	requestManager->onBackpressureChanged(true);
+	requestManager->createRequest(RequestManager::GetBalance, QVariantMap());
+	requestManager->createRequest(RequestManager::UpdatePassword, QVariantMap({{"new_password", "a"}}));
+	requestManager->createRequest(RequestManager::GetBalance, QVariantMap());
+	const qint64 lastBalance = requestManager->lastRequestId();
+	requestManager->createRequest(RequestManager::UpdatePassword, QVariantMap({{"new_password", "a"}}));
+	EXPECT_EQ(requestSpy.count(), 0);
+
+	requestManager->onBackpressureChanged(false);
+
+	// Writes are all sent, the balance once with the RequestId of the last copy, in creation order
+	ASSERT_EQ(requestSpy.count(), 3);
+	const QJsonObject balance = requestSpy.at(1).first().value<MessagePtr>()->envelope();
+	EXPECT_EQ(requestSpy.at(0).first().value<MessagePtr>()->envelope().value("Request").toInt(),
+			  RequestManager::UpdatePassword);
+	EXPECT_EQ(balance.value("Request").toInt(), RequestManager::GetBalance);
+	EXPECT_EQ(balance.value("RequestId").toInteger(), lastBalance);
+}
+
+TEST(RequestManagerTest, Backpressure_DropsBeyondTheLimit)
+{
+	RequestManager* requestManager = RequestManager::getInstance();
+	QSignalSpy		requestSpy(requestManager, &RequestManager::makeRequest);
+	QSignalSpy		droppedSpy(requestManager, &RequestManager::requestDropped);
+
+	requestManager->onBackpressureChanged(true);
+	for (int i = 0; i <= RequestManager::MaxDeferredRequests; ++i)
+	{
+		EXPECT_FALSE(requestManager->createRequest(RequestManager::DeleteUser, QVariantMap({{"account_number", i}})));
+	}
+
+	ASSERT_EQ(droppedSpy.count(), 1);
+	EXPECT_EQ(droppedSpy.first().first().toLongLong(), requestManager->lastRequestId());
+
+	requestManager->onBackpressureChanged(false);
+	EXPECT_EQ(requestSpy.count(), RequestManager::MaxDeferredRequests);
+}
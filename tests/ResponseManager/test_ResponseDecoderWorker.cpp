@@ -0,0 +1,56 @@
+#include <gtest/gtest.h>
+#include <QJsonObject>
+
+#include "ResponseDecoderWorker.h"
+#include "ResponseManager.h"
+
+// Test Fixture
+class ResponseDecoderWorkerTest : public ::testing::Test
+{
+protected:
+	ResponseDecoderWorker worker;
+	QList<ResponsePtr>	  decoded;
+
+	void SetUp() override
+	{
+		QObject::connect(&worker, &ResponseDecoderWorker::responseDecoded,
+						 [this](ResponsePtr response) { decoded.append(response); });
+	}
+};
+
+TEST_F(ResponseDecoderWorkerTest, Decode_NotModified_KeepsOnlyTheEnvelope)
+{
+	QJsonObject envelope{{"Response", ResponseManager::NotModified}, {"RequestId", 42}};
+
+	for (MessageCodec::Format format : {MessageCodec::Json, MessageCodec::Cbor})
+	{
+		decoded.clear();
+		worker.decode(NetworkMessage::fromPayload(MessageCodec::forFormat(format).encode(envelope), format));
+
+		ASSERT_EQ(decoded.size(), 1);
+		EXPECT_EQ(decoded.first()->code, ResponseManager::NotModified);
+		EXPECT_EQ(decoded.first()->requestId, 42);
+		EXPECT_TRUE(decoded.first()->data.isEmpty());
+	}
+}
+
+TEST_F(ResponseDecoderWorkerTest, Decode_NotModified_WithoutRequestId)
+{
+	worker.decode(NetworkMessage::fromPayload(R"({"Response":-3})", MessageCodec::Json));
+
+	ASSERT_EQ(decoded.size(), 1);
+	EXPECT_EQ(decoded.first()->code, ResponseManager::NotModified);
+	EXPECT_EQ(decoded.first()->requestId, -1);
+}
+
+TEST_F(ResponseDecoderWorkerTest, Decode_OtherReplies_AreFullyDecoded)
+{
+	worker.decode(
+		NetworkMessage::fromPayload(R"({"Response":7,"RequestId":5,"Data":{"users":[{"email":"a@b.c"}]}})",
+									MessageCodec::Json));
+
+	ASSERT_EQ(decoded.size(), 1);
+	EXPECT_EQ(decoded.first()->code, 7);
+	EXPECT_EQ(decoded.first()->requestId, 5);
+	EXPECT_EQ(decoded.first()->users.size(), 1);
+}
@@ -105,6 +105,33 @@ TEST_F(ResponseManagerTest, HandleResponse_Login_Failed)
 
 // Add more tests for different response codes as needed...
 
+TEST_F(ResponseManagerTest, HandleResponse_CombinedLogin_CreatesUserDirectly)
+{
+	QSignalSpy userSpy(responseManager, &ResponseManager::userloginSuccess);
+	QSignalSpy acceptedSpy(responseManager, &ResponseManager::LoginAccepted);
+
+	QJsonObject data;
+	data.insert("Response", ResponseManager::Login);
+	QJsonObject dataObject;
+	dataObject.insert("status", 1);
+	dataObject.insert("init", true);
+	dataObject.insert("role", "user");
+	dataObject.insert("first_name", "Ali");
+	dataObject.insert("email", "a@b.c");
+	dataObject.insert("account_number", 1001);
+	dataObject.insert("current_balance", 12.5);
+	data.insert("Data", dataObject);
+
+	responseManager->handleResponse(data);
+
+	EXPECT_EQ(acceptedSpy.count(), 0);
+	ASSERT_EQ(userSpy.count(), 1);
+	QList<QVariant> arguments = userSpy.takeFirst();
+	EXPECT_EQ(arguments.at(0).toString(), "a@b.c");
+	EXPECT_EQ(arguments.at(2).toString(), "1001");
+	EXPECT_EQ(arguments.at(3).toString(), "12.50");
+}
+
 // Example for handling signals
 TEST_F(ResponseManagerTest, HandleResponse_Successful_FetchBalance)
 {
@@ -122,3 +149,158 @@ TEST_F(ResponseManagerTest, HandleResponse_Successful_FetchBalance)
 	QList<QVariant> fetchedSignals = balanceFetchedSpy.takeFirst();
 	EXPECT_EQ(fetchedSignals.first().toString(), "123.45");
 }
+
+TEST_F(ResponseManagerTest, HandleResponse_NotModified_EmitsRequestId)
+{
+	QSignalSpy unchangedSpy(responseManager, &ResponseManager::ResultUnchanged);
+	QSignalSpy failedRequestSpy(responseManager, &ResponseManager::FailedRequest);
+
+	QJsonObject data;
+	data.insert("Response", ResponseManager::NotModified);
+	data.insert("RequestId", 17);
+	data.insert("Data", QJsonObject());
+
+	responseManager->handleResponse(data);
+
+	ASSERT_EQ(unchangedSpy.count(), 1);
+	EXPECT_EQ(unchangedSpy.takeFirst().first().toLongLong(), 17);
+	EXPECT_EQ(failedRequestSpy.count(), 0);
+}
+
+TEST_F(ResponseManagerTest, HandleResponse_TransactionsEvent_EmitsPushedRows)
+{
+	QSignalSpy pushedSpy(responseManager, &ResponseManager::TransactionsPushed);
+	QSignalSpy failedRequestSpy(responseManager, &ResponseManager::FailedRequest);
+
+	QByteArray payload = R"({"Response":-4,"Data":{"event":"transactions","List":[{"from_account_number":1,
+		"to_account_number":2,"amount":3.5,"created_at":"2024-01-02 03:04:05"}]}})";
+
+	responseManager->handleDecodedResponse(ResponseDecoder::decode(payload, MessageCodec::Json));
+
+	ASSERT_EQ(pushedSpy.count(), 1);
+	TransactionPage page = pushedSpy.takeFirst().first().value<TransactionPage>();
+	ASSERT_EQ(page.rows.size(), 1);
+	EXPECT_EQ(page.rows.at(0).amountCents, 350);
+	EXPECT_EQ(page.requestId, -1);
+	EXPECT_EQ(failedRequestSpy.count(), 0);
+}
+
+TEST_F(ResponseManagerTest, HandleResponse_BalanceChangedEvent_EmitsPartialUpdate)
+{
+	QSignalSpy changedSpy(responseManager, &ResponseManager::UsersChanged);
+
+	QByteArray payload =
+		R"({"Response":-4,"Data":{"event":"balance_changed","users":[{"account_number":1001,"balance":20}]}})";
+
+	responseManager->handleDecodedResponse(ResponseDecoder::decode(payload, MessageCodec::Json));
+
+	ASSERT_EQ(changedSpy.count(), 1);
+	UserChange change = changedSpy.takeFirst().first().value<UserChange>();
+	EXPECT_EQ(change.kind, UserChange::Updated);
+	EXPECT_EQ(change.fields, UserRecord::AccountNumberField | UserRecord::BalanceField);
+
+	UserRecord shown;
+	shown.accountNumber = 1001;
+	shown.role = UserRecord::User;
+	shown.email = "a@b.c";
+	ASSERT_TRUE(shown.isSameUser(change.users.at(0)));
+	shown.assignFields(change.users.at(0), change.fields);
+	EXPECT_EQ(shown.balanceCents, 2000);
+	EXPECT_EQ(shown.email, "a@b.c");
+}
+
+// Tests for the streaming decoder, which must build the same rows as the QJsonObject path
+TEST_F(ResponseManagerTest, Decode_DatabaseRows_MatchesObjectPath)
+{
+	QByteArray payload = R"({"Response":7,"RequestId":42,"Data":{"status":1,"extra":{"a":[1,{"b":"}"}]},
+		"users":[{"first_name":"Ali \"A\" é","last_name":"Z","email":"a@b.c","role":"user",
+		"account_number":1001,"balance":12.5,"ignored":[1,2,3]},{"first_name":"Only"}]}})";
+
+	DecodedResponse streamed = ResponseDecoder::decode(payload, MessageCodec::Json);
+	DecodedResponse reference = ResponseDecoder::fromObject(QJsonDocument::fromJson(payload).object());
+
+	EXPECT_EQ(streamed.code, 7);
+	EXPECT_EQ(streamed.requestId, 42);
+	ASSERT_EQ(streamed.users.size(), 2);
+	EXPECT_EQ(streamed.users, reference.users);
+	EXPECT_EQ(streamed.data, reference.data);
+	EXPECT_EQ(streamed.users.at(0).firstName, QString::fromUtf8("Ali \"A\" \xc3\xa9"));
+	EXPECT_EQ(streamed.users.at(0).role, UserRecord::User);
+	EXPECT_EQ(streamed.users.at(0).accountNumber, 1001);
+	EXPECT_EQ(streamed.users.at(0).balanceCents, 1250);
+	EXPECT_EQ(streamed.users.at(1).accountNumber, 0);
+	EXPECT_EQ(streamed.users.at(1).role, UserRecord::UnknownRole);
+	EXPECT_EQ(streamed.userFields, UserRecord::AllFields);
+	EXPECT_EQ(streamed.userFields, reference.userFields);
+}
+
+TEST_F(ResponseManagerTest, Decode_ProjectedUsers_ReportsFieldsSent)
+{
+	QByteArray payload = R"({"Response":7,"Data":{"status":1,"users":[{"email":"a@b.c","account_number":1001}]}})";
+
+	DecodedResponse streamed = ResponseDecoder::decode(payload, MessageCodec::Json);
+
+	ASSERT_EQ(streamed.users.size(), 1);
+	EXPECT_EQ(streamed.userFields, UserRecord::EmailField | UserRecord::AccountNumberField);
+	EXPECT_EQ(UserRecord::fieldNames(streamed.userFields), QStringList({"account_number", "email"}));
+}
+
+TEST_F(ResponseManagerTest, Decode_CborTransactions_MatchesObjectPath)
+{
+	QJsonObject transaction;
+	transaction.insert("from_account_number", 1001);
+	transaction.insert("to_account_number", 1002);
+	transaction.insert("amount", 7.25);
+	transaction.insert("created_at", "2024-06-01 10:00:00");
+
+	QJsonObject dataObject;
+	dataObject.insert("status", 1);
+	dataObject.insert("List", QJsonArray({transaction, transaction}));
+
+	QJsonObject envelope;
+	envelope.insert("Response", 4);
+	envelope.insert("Data", dataObject);
+
+	DecodedResponse streamed = ResponseDecoder::decode(MessageCodec::forFormat(MessageCodec::Cbor).encode(envelope),
+													   MessageCodec::Cbor);
+
+	EXPECT_EQ(streamed.code, 4);
+	ASSERT_EQ(streamed.transactions.size(), 2);
+	EXPECT_EQ(streamed.transactions, ResponseDecoder::fromObject(envelope).transactions);
+	EXPECT_EQ(streamed.transactions.at(0).amountCents, 725);
+	EXPECT_EQ(TransactionStore::formatTimestamp(streamed.transactions.at(0).createdAt), "2024-06-01 10:00:00");
+}
+
+TEST_F(ResponseManagerTest, Decode_TruncatedPayload_IsParseError)
+{
+	DecodedResponse streamed = ResponseDecoder::decode(R"({"Response":7,"Data":{"users":[{"email":"a)",
+													   MessageCodec::Json);
+
+	EXPECT_EQ(streamed.code, ResponseManager::JsonParseError);
+	EXPECT_TRUE(streamed.users.isEmpty());
+}
+
+TEST(TransactionStoreTest, Values_RoundTripThroughText)
+{
+	EXPECT_EQ(TransactionStore::toCents(0.1 + 0.2), 30);
+	EXPECT_EQ(TransactionStore::formatAmount(-1250), "-12.50");
+	EXPECT_EQ(TransactionStore::parseTimestamp(u"1970-01-01T00:00:01.250Z"), 1250);
+	EXPECT_EQ(TransactionStore::parseTimestamp(u"2024-06-01 12:00:00+02:00"),
+			  TransactionStore::parseTimestamp(u"2024-06-01 10:00:00"));
+	EXPECT_EQ(TransactionStore::parseTimestamp(u"yesterday"), TransactionStore::InvalidTimestamp);
+}
+
+TEST(TransactionStoreTest, ParseTimestamp_AcceptsEveryOffsetForm)
+{
+	const qint64 utc = TransactionStore::parseTimestamp(u"2024-06-01 10:00:00");
+
+	// PostgreSQL's text form of timestamptz: microseconds and an hour-only offset
+	EXPECT_EQ(TransactionStore::parseTimestamp(u"2024-06-01 10:00:00.123456+00"), utc + 123);
+	EXPECT_EQ(TransactionStore::parseTimestamp(u"2024-06-01 12:00:00+02"), utc);
+	EXPECT_EQ(TransactionStore::parseTimestamp(u"2024-06-01 03:00:00-07"), utc);
+	EXPECT_EQ(TransactionStore::parseTimestamp(u"2024-06-01 15:30:00+0530"), utc);
+	EXPECT_EQ(TransactionStore::parseTimestamp(u"2024-06-01T10:00:00.000Z"), utc);
+
+	// Forms the fast path does not know fall back to QDateTime instead of being rejected
+	EXPECT_EQ(TransactionStore::parseTimestamp(u"2024-06-01T10:00Z"), utc);
+}
@@ -0,0 +1,160 @@
+#include <gtest/gtest.h>
+#include <QApplication>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QLabel>
+#include <QSignalSpy>
+#include <QTimer>
+
+#include "qtmaterialflatbutton.h"
+#include "qtmaterialtextfield.h"
+
+#include "UserWidget.h"
+
+// Test Fixture
+class UserWidgetTest : public ::testing::Test
+{
+protected:
+	static void SetUpTestSuite()
+	{
+		// Widgets need an application object, the offscreen platform needs no display
+		if (QApplication::instance() == nullptr)
+		{
+			qputenv("QT_QPA_PLATFORM", "offscreen");
+
+			static int	argc = 1;
+			static char name[] = "Widgets_tests";
+			static char* argv[] = {name, nullptr};
+			new QApplication(argc, argv);
+		}
+
+		// The shared RequestManager must outlive the widgets of every test
+		RequestManager::getInstance(nullptr);
+	}
+
+	// Clicks the button with the given text and fills the modal dialog it opens, field by field
+	static void submitDialog(QWidget* widget, const QString& buttonText, const QStringList& fieldValues)
+	{
+		QTimer::singleShot(0, [fieldValues]() {
+			QWidget* dialog = QApplication::activeModalWidget();
+			ASSERT_NE(dialog, nullptr);
+
+			QList<QtMaterialTextField*> fields = dialog->findChildren<QtMaterialTextField*>();
+			ASSERT_EQ(fields.size(), fieldValues.size());
+
+			for (int i = 0; i < fields.size(); ++i)
+			{
+				fields[i]->setText(fieldValues[i]);
+			}
+			static_cast<QDialog*>(dialog)->accept();
+		});
+
+		for (QtMaterialFlatButton* button : widget->findChildren<QtMaterialFlatButton*>())
+		{
+			if (button->text() == buttonText)
+			{
+				button->click();
+				return;
+			}
+		}
+		FAIL() << "No button named " << buttonText.toStdString();
+	}
+
+	// Returns the text field with the given placeholder
+	static QtMaterialTextField* textField(QWidget* widget, const QString& placeholder)
+	{
+		for (QtMaterialTextField* field : widget->findChildren<QtMaterialTextField*>())
+		{
+			if (field->placeholderText() == placeholder)
+			{
+				return field;
+			}
+		}
+		return nullptr;
+	}
+
+	// Returns the Data of the last request sent
+	static QJsonObject lastRequestData(const QSignalSpy& spy)
+	{
+		return spy.last().at(0).value<MessagePtr>()->envelope()["Data"].toObject();
+	}
+};
+
+TEST_F(UserWidgetTest, UpdateEmail_Success_SendsTheNewEmail)
+{
+	RequestManager* requestManager = RequestManager::getInstance();
+	requestManager->openSession("old@bank.com");
+
+	UserWidget widget("old@bank.com", "Ada", "1001", "10.00");
+	QSignalSpy spy(requestManager, &RequestManager::makeRequest);
+
+	submitDialog(&widget, "Update Email", {"old@bank.com", "new@bank.com", "Passw0rd!"});
+
+	ASSERT_EQ(spy.size(), 1);
+	EXPECT_EQ(lastRequestData(spy)["new_email"].toString(), "new@bank.com");
+
+	widget.onSuccessfullRequest("Email updated successfully");
+
+	// Requests sent from now on identify the user by the new email
+	requestManager->createRequest(RequestManager::GetBalance, QVariantMap());
+	ASSERT_EQ(spy.size(), 2);
+	EXPECT_EQ(lastRequestData(spy)["email"].toString(), "new@bank.com");
+
+	requestManager->closeSession();
+}
+
+TEST_F(UserWidgetTest, UpdateEmail_WrongCurrentEmail_SendsNothing)
+{
+	RequestManager* requestManager = RequestManager::getInstance();
+	requestManager->openSession("old@bank.com");
+
+	UserWidget widget("old@bank.com", "Ada", "1001", "10.00");
+	QSignalSpy spy(requestManager, &RequestManager::makeRequest);
+
+	submitDialog(&widget, "Update Email", {"other@bank.com", "new@bank.com", "Passw0rd!"});
+
+	EXPECT_EQ(spy.size(), 0);
+
+	requestManager->closeSession();
+}
+
+TEST_F(UserWidgetTest, RecipientLookup_RequestsOnlyTheName)
+{
+	RequestManager* requestManager = RequestManager::getInstance();
+	requestManager->openSession("old@bank.com");
+
+	UserWidget widget("old@bank.com", "Ada", "1001", "10.00");
+	QSignalSpy spy(requestManager, &RequestManager::makeRequest);
+
+	QtMaterialTextField* toAccount = textField(&widget, "To Account");
+	ASSERT_NE(toAccount, nullptr);
+	toAccount->setText("100002");
+
+	// The lookup is sent once typing pauses
+	ASSERT_TRUE(spy.wait(1000));
+	ASSERT_EQ(spy.size(), 1);
+
+	const QJsonObject envelope = spy.last().at(0).value<MessagePtr>()->envelope();
+	const QJsonObject data = envelope["Data"].toObject();
+	EXPECT_EQ(envelope["Request"].toInt(), RequestManager::SearchUsers);
+	EXPECT_EQ(data["account_min"].toInteger(), 100002);
+	EXPECT_EQ(data["account_max"].toInteger(), 100002);
+	EXPECT_EQ(data["fields"].toArray(), QJsonArray({"first_name", "last_name"}));
+
+	UserPage page;
+	page.requestId = envelope["RequestId"].toInteger();
+	page.fields = UserRecord::FirstNameField | UserRecord::LastNameField;
+	page.users.append(UserRecord());
+	page.users.first().firstName = "Grace";
+	page.users.first().lastName = "Hopper";
+	widget.onUsersFound(page);
+
+	bool shown = false;
+	for (QLabel* label : widget.findChildren<QLabel*>())
+	{
+		shown = shown || label->text() == "To Grace Hopper";
+	}
+	EXPECT_TRUE(shown);
+
+	requestManager->closeSession();
+}
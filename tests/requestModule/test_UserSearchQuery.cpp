@@ -0,0 +1,49 @@
+#include <gtest/gtest.h>
+
+#include "UserSearchQuery.h"
+
+TEST(UserSearchQueryTest, Parse_TermsAndRanges)
+{
+	UserSearchQuery query = UserSearchQuery::parse(u"smi role:admin balance:10.5-200 account:1000- a@b");
+
+	EXPECT_EQ(query.prefix, "smi");
+	EXPECT_TRUE(query.namePrefix.isEmpty());
+	EXPECT_EQ(query.emailPrefix, "a@b");
+	EXPECT_EQ(query.role, UserRecord::Admin);
+	EXPECT_EQ(query.minBalanceCents, 1050);
+	EXPECT_EQ(query.maxBalanceCents, 20000);
+	EXPECT_EQ(query.minAccount, 1000);
+	EXPECT_EQ(query.maxAccount, UserSearchQuery::Unbounded);
+
+	QVariantMap data = query.toVariantMap();
+	EXPECT_EQ(data.value("balance_min").toDouble(), 10.5);
+	EXPECT_FALSE(data.contains("account_max"));
+
+	EXPECT_EQ(data.value("prefix").toString(), "smi");
+	EXPECT_FALSE(data.contains("name_prefix"));
+
+	EXPECT_EQ(UserSearchQuery::parse(u"1001").minAccount, 1001);
+	EXPECT_TRUE(UserSearchQuery::parse(u"  balance:abc ").isEmpty());
+}
+
+TEST(UserSearchQueryTest, Matches_EvaluatesEveryCriterion)
+{
+	UserRecord user;
+	user.accountNumber = 1042;
+	user.firstName = "Jane";
+	user.lastName = "Smith";
+	user.email = "jane@bank.io";
+	user.role = UserRecord::User;
+	user.balanceCents = 12550;
+
+	// A bare term matches the email or either name
+	EXPECT_TRUE(UserSearchQuery::parse(u"smi").matches(user));
+	EXPECT_TRUE(UserSearchQuery::parse(u"JAN").matches(user));
+	EXPECT_FALSE(UserSearchQuery::parse(u"bank").matches(user));
+	EXPECT_FALSE(UserSearchQuery::parse(u"name:jane@").matches(user));
+
+	EXPECT_TRUE(UserSearchQuery::parse(u"role:user balance:100-200 account:1000-").matches(user));
+	EXPECT_FALSE(UserSearchQuery::parse(u"role:admin").matches(user));
+	EXPECT_FALSE(UserSearchQuery::parse(u"balance:-125").matches(user));
+	EXPECT_TRUE(UserSearchQuery::parse(u"1042 email:jane").matches(user));
+}